@@ -4,7 +4,11 @@
 #include "algorithms/DSaturColoring.h"
 #include "algorithms/GreedyHeuristicsColoring.h"
 #include "algorithms/DSaturBnB.h"
+#include "algorithms/Components.h"
+#include "algorithms/Kernelization.h"
 #include "algorithms/MISBacktracking.h"
+#include "algorithms/Portfolio.h"
+#include "algorithms/Relabel.h"
 
 #include "method/Graph.h"
 #include "method/OlemskoyColorGraph.h"
@@ -58,22 +62,41 @@ static void runOnDense(int n,
     // std::cout << (isProperColoring(M, greedHObj) ? "✔ корректно\n\n"
     //                                          : "✖ конфликт!\n\n");
 
+    // граф в CSR — один раз для всех алгоритмов
+    const CsrGraph G = CsrGraph::fromDense(M);
+
+    // аппаратные счётчики (если доступны) — открываются один раз
+    static perf::Counters counters;
+
     // 4) DSATUR-BnB — гарантировано минимальное χ
-    auto [bnbColorVec, tDBnB] = timeit([&]{ return DSaturBnB::color(M); });
+    auto [bnbColorVec, tDBnB, pDBnB] = timeitPerf([&]{ return DSaturBnB::color(G); }, counters);
     std::cout << "DSATUR-BnB (точный):\n";
     printColoring(bnbColorVec);
-    std::cout << "Время: " << tDBnB << " c\n\n";
-    std::cout << (isProperColoring(M, bnbColorVec, false) ? "✔ корректно\n\n"
+    std::cout << "Время: " << tDBnB << " c\n";
+    printPerf(pDBnB);
+    std::cout << '\n';
+    std::cout << (isProperColoring(G, bnbColorVec, false) ? "✔ корректно\n\n"
                                                      : "✖ конфликт!\n\n");
 
     // 5) MISBacktracking — гарантировано минимальное χ
-    auto [backtrackingVec, tBactracking] = timeit([&]{ return BacktrackingColoring::color(M); });
+    auto [backtrackingVec, tBactracking, pBactracking] =
+        timeitPerf([&]{ return BacktrackingColoring::color(G); }, counters);
     std::cout << "MISBacktracking (точный):\n";
     printColoring(backtrackingVec);
-    std::cout << "Время: " << tBactracking << " c\n\n";
-    std::cout << (isProperColoring(M, backtrackingVec, false) ? "✔ корректно\n\n"
+    std::cout << "Время: " << tBactracking << " c\n";
+    printPerf(pBactracking);
+    std::cout << '\n';
+    std::cout << (isProperColoring(G, backtrackingVec, false) ? "✔ корректно\n\n"
                                                      : "✖ конфликт!\n\n");
-    // 6) Метод Олемского
+    // 6) Портфель — все решатели наперегонки, общие UB и LB
+    auto [pf, tPf] = timeit([&]{ return portfolio::solve(G); });
+    std::cout << "Портфель (" << (pf.winner >= 0 ? portfolio::solverName(pf.winner) : "trivial")
+              << ", LB=" << pf.lowerBound << (pf.optimal ? ", оптимум" : "") << "):\n";
+    printColoring(pf.colouring);
+    std::cout << "Время: " << tPf << " c\n\n";
+    std::cout << (isProperColoring(G, pf.colouring, false) ? "✔ корректно\n\n"
+                                                      : "✖ конфликт!\n\n");
+    // 7) Метод Олемского
     // auto [olemSol, tO] = timeit([&]{ 
     //     Graph G(M);
     //     OlemskoyColorGraph ocg(G);
@@ -120,7 +143,10 @@ inline void runBenchmarks(int n,
 
     for (double d : densities)
     {
-        auto denseList = generateDenseMatrices(n, d, perDensity);
+        const std::uint64_t seed = randomSeed();
+        std::cout << "=== n=" << n << " d=" << d << " seed=" << seed
+                  << " (matrix #i: seed+i) ===\n";
+        auto denseList = generateDenseMatrices(n, d, perDensity, seed);
         for (int i = 0; i < perDensity; ++i)
         {
             runOnDense(n, denseList[i], d, i);
@@ -6,14 +6,21 @@
 #include <unordered_map>
 #include <algorithm>
 #include <chrono>
+#include <memory>
 #include <random>
 #include <Eigen/Dense>
 
 
+#include <cstdint>
+#include <tuple>
 #include <type_traits>
 
 #include "algorithms/GreedyHeuristicsColoring.h" 
 #include "method/Graph.h"
+#include "ColoringValidator.h"
+#include "CsrGraph.h"
+#include "PerfCounters.h"
+#include "RandomGraph.h"
 
 using Clock = std::chrono::high_resolution_clock;
 
@@ -28,7 +35,8 @@ template<class Matrix>
 inline void printColoring(const greedy::Coloring<Matrix>& solver)
 {
     std::map<int, std::vector<int>> byColor;
-    for (const auto& [v,c] : solver.colors()) byColor[c].push_back(v);
+    const auto& col = solver.colors();
+    for (size_t v = 0; v < col.size(); ++v) byColor[col[v]].push_back(static_cast<int>(v));
 
     std::cout << "χ = " << solver.chromaticNumber() << '\n';
     // for (auto& [c, vs] : byColor) {
@@ -70,29 +78,33 @@ inline void printColoring(const std::vector<std::vector<int>>& groups)
 }
 /*------------------------------------------------------------------*
  |  generateDenseMatrices: produce symmetric random 0/1 matrices
+ |  G(n, density), matrix k from seed + k (RandomGraph.h) — any
+ |  instance can be replayed as RandomGraph::gnpDense(n, d, seed + k)
  *------------------------------------------------------------------*/
 
-static std::vector<DenseMatrix>
-generateDenseMatrices(int n, double density, int count)
+inline std::vector<DenseMatrix>
+generateDenseMatrices(int n, double density, int count, std::uint64_t seed)
 {
-    std::mt19937_64 rng{std::random_device{}()};
-    std::bernoulli_distribution coin(density);
-    auto gen = [&](Eigen::Index, Eigen::Index){ return static_cast<int>(coin(rng)); };
-
     std::vector<DenseMatrix> out;
     out.reserve(count);
-    for (int k = 0; k < count; ++k) {
-        DenseMatrix A = DenseMatrix::Zero(n, n);
-        A.template triangularView<Eigen::StrictlyUpper>() =
-            DenseMatrix::NullaryExpr(n, n, gen)
-            .template triangularView<Eigen::StrictlyUpper>();
-        A.template triangularView<Eigen::StrictlyLower>() =
-            A.transpose().template triangularView<Eigen::StrictlyLower>();
-        out.emplace_back(std::move(A));
-    }
+    for (int k = 0; k < count; ++k)
+        out.emplace_back(RandomGraph::gnpDense(n, density, seed + k));
     return out;
 }
 
+/* fresh seed per call (print it to be able to replay the run) */
+inline std::uint64_t randomSeed()
+{
+    std::random_device rd;
+    return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+}
+
+inline std::vector<DenseMatrix>
+generateDenseMatrices(int n, double density, int count)
+{
+    return generateDenseMatrices(n, density, count, randomSeed());
+}
+
 /*------------------------------------------------------------------*
  |  timeit: measure function returning any T, returns pair<T,double>
  *------------------------------------------------------------------*/
@@ -106,6 +118,92 @@ auto timeit(F&& fn)
     return std::pair{ std::move(res), std::chrono::duration<double>(t1 - t0).count() };
 }
 
+/*------------------------------------------------------------------*
+ |  timeitPerf: timeit plus hardware counters (PerfCounters.h) around
+ |  the call; returns tuple<T, double, perf::Sample>. Counters that
+ |  cannot be opened are simply absent from the sample.
+ *------------------------------------------------------------------*/
+
+template<typename F>
+auto timeitPerf(F&& fn, perf::Counters& counters)
+{
+    counters.start();
+    auto t0 = Clock::now();
+    auto res = fn();
+    auto t1 = Clock::now();
+    const perf::Sample s = counters.stop();
+    return std::tuple{ std::move(res), std::chrono::duration<double>(t1 - t0).count(), s };
+}
+
+/* counters next to the timing; nothing if none were available */
+inline void printPerf(const perf::Sample& s)
+{
+    if (!s.any()) return;
+    std::cout << "Счётчики:";
+    for (int e = 0; e < perf::kEventCount; ++e)
+        if (s.has(e)) std::cout << ' ' << perf::eventName(e) << '=' << s.value[e];
+    if (s.ipc() > 0) std::cout << " IPC=" << s.ipc();
+    if (s.multiplexed) std::cout << " (мультиплексированы)";
+    std::cout << '\n';
+}
+
+/*------------------------------------------------------------------*
+ |  timeRuns: warmup unmeasured runs, then repeat measured ones on
+ |  steady_clock; returns the last result and every sample (seconds).
+ |  perfSamples != nullptr → also hardware counters of every measured
+ |  run (empty samples if perf_event_open is unavailable)
+ *------------------------------------------------------------------*/
+
+template<typename F>
+auto timeRuns(F&& fn, int warmup, int repeat,
+              std::vector<perf::Sample>* perfSamples = nullptr)
+{
+    using SteadyClock = std::chrono::steady_clock;
+    for (int k = 0; k < warmup; ++k) (void)fn();
+
+    std::unique_ptr<perf::Counters> counters;
+    if (perfSamples) {
+        counters = std::make_unique<perf::Counters>();
+        perfSamples->clear();
+    }
+
+    std::vector<double> times;
+    times.reserve(std::max(repeat, 1));
+    decltype(fn()) res{};
+    for (int k = 0; k < std::max(repeat, 1); ++k) {
+        if (counters) counters->start();
+        auto t0 = SteadyClock::now();
+        res = fn();
+        auto t1 = SteadyClock::now();
+        if (counters) perfSamples->push_back(counters->stop());
+        times.push_back(std::chrono::duration<double>(t1 - t0).count());
+    }
+    return std::pair{ std::move(res), std::move(times) };
+}
+
+/*------------------------------------------------------------------*
+ |  TimeStats: min / median / p95 (nearest rank) / mean of samples
+ *------------------------------------------------------------------*/
+
+struct TimeStats
+{
+    double min = 0, median = 0, p95 = 0, mean = 0;
+};
+
+inline TimeStats summarize(std::vector<double> t)
+{
+    TimeStats s;
+    if (t.empty()) return s;
+    std::sort(t.begin(), t.end());
+    const std::size_t k = t.size();
+    s.min    = t.front();
+    s.median = k % 2 ? t[k / 2] : 0.5 * (t[k / 2 - 1] + t[k / 2]);
+    s.p95    = t[(95 * k + 99) / 100 - 1];                 // ⌈0.95·k⌉-й
+    for (double x : t) s.mean += x;
+    s.mean /= static_cast<double>(k);
+    return s;
+}
+
 
 /*---------------------------------------------------------------*
  |  1. проверка (adjacency-list  +  vector<int>)                 |
@@ -133,6 +231,26 @@ inline bool isProperColoring(
     return true;
 }
 
+/*---------------------------------------------------------------*
+ |  1a. проверка (CSR  +  vector<int>)                           |
+ |      validate::check — параллельно по блокам рёбер            |
+ *---------------------------------------------------------------*/
+inline bool reportColoring(const validate::Report& r)
+{
+    for (const auto& c : r.conflicts)
+        std::cerr << "Conflict: ("<<c.u<<","<<c.v<<") both color "
+                  << c.colour << "\n";
+    return r.ok();
+}
+
+inline bool isProperColoring(
+        const CsrGraph& g,
+        const std::vector<int>& color,
+        bool oneBased = true)
+{
+    return reportColoring(validate::check(g, color, oneBased ? 1 : 0));
+}
+
 /*---------------------------------------------------------------*
  |  2. проверка (0/1-матрица  +  vector<int>)                    |
  *---------------------------------------------------------------*/
@@ -143,19 +261,8 @@ auto isProperColoring(
         bool oneBased = true)
         -> decltype(M.rows(), true)
 {
-    const int n = M.rows();
-    if ((int)color.size() != n) return false;
-
-    for (int i = 0; i < n; ++i)
-        for (int j = i + 1; j < n; ++j)
-            if (M(i,j) && color[i] == color[j]) {
-                std::cerr << "Conflict: ("<<i<<","<<j<<") both color "
-                          << color[i] << "\n";
-                return false;
-            }
-    if (oneBased)
-        for (int c : color) if (c < 1) return false;
-    return true;
+    if ((int)color.size() != M.rows()) return false;
+    return isProperColoring(CsrGraph::fromDense(M), color, oneBased);
 }
 
 /*---------------------------------------------------------------*
@@ -165,10 +272,7 @@ template<class Matrix>
 bool isProperColoring(const Matrix& M,
                       const greedy::Coloring<Matrix>& solver)
 {
-    /* формируем массив цветов 0-based */
-    std::vector<int> col(M.rows(), 0);
-    for (auto& [v,c] : solver.colors()) col[v] = c;   // цвета 1-based
-    return isProperColoring(M, col, true);
+    return isProperColoring(M, solver.colors(), true);   // цвета 1-based
 }
 
 inline bool isProperColoring(const std::vector<std::vector<int>>& adj,
@@ -201,4 +305,39 @@ bool isProperColoring(
     }
     // вызываем уже существующую проверку для вектора цветов
     return isProperColoring(M, col, oneBased);
-}
\ No newline at end of file
+}
+/*---------------------------------------------------------------*
+ |  5. проверка по упакованным строкам Graph (цветовые классы)   |
+ |     класс корректен ⇔ adjRow(v) ∧ класс = ∅ для всех v       |
+ *---------------------------------------------------------------*/
+inline bool isProperColoring(const Graph& g,
+                             const std::vector<std::vector<int>>& groups)
+{
+    const int n = g.size();
+    std::vector<char> seen(n, 0);
+    bits::WordVector cls = g.makeRow();
+
+    for (size_t c = 0; c < groups.size(); ++c) {
+        std::fill(cls.begin(), cls.end(), 0);
+        for (int v : groups[c]) {
+            if (v < 0 || v >= n || seen[v]) return false;  // неверный индекс / повтор
+            seen[v] = 1;
+            bits::set(cls.data(), v);
+        }
+        for (int v : groups[c])
+            if (g.intersects(g.adjRow(v), cls.data())) {
+                std::cerr << "Conflict: vertex " << v << " in color "
+                          << c + 1 << "\n";
+                return false;
+            }
+    }
+    for (char s : seen) if (!s) return false;             // не все вершины покрашены
+    return true;
+}
+
+inline bool isProperColoring(const Graph& g,
+                             const std::vector<int>& color,
+                             bool oneBased = true)
+{
+    return reportColoring(validate::check(g, color, oneBased ? 1 : 0));
+}
@@ -0,0 +1,264 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "CsrGraph.h"
+#include "WorkStealingPool.h"
+#include "method/Bitset.h"
+#include "method/Graph.h"
+
+/*---------------------------------------------------------------*
+ |  Проверка раскраски больших графов                             |
+ |                                                                |
+ |  check(CsrGraph, …)  — каждое ребро (u < v) один раз, O(n + m);|
+ |  checkPacked(строки, …) — по упакованным строкам смежности:    |
+ |      для каждого цвета строка-класс, и вершина v проверяется    |
+ |      одним проходом adjRow(v) ∧ класс(color[v]) по словам       |
+ |      правее v, блоками по кэш-линии (OR-свёртка без ветвлений   |
+ |      внутри блока — векторизуется).                            |
+ |                                                                |
+ |  Работа режется на блоки вершин примерно равной стоимости      |
+ |  (kChunkWork слов/соседей) и раздаётся WorkStealingPool;        |
+ |  маленькие графы проверяются в вызывающем потоке.               |
+ |                                                                |
+ |  Mode::First — только первый конфликт в порядке (u, v), и он   |
+ |  тот же при любом числе потоков: блоки правее уже найденного    |
+ |  конфликта бросаются. Mode::All — все конфликты, по (u, v).    |
+ |                                                                |
+ |  Цвета < base — «не окрашено»: такие вершины в конфликтах не    |
+ |  участвуют, а считаются в uncoloured.                          |
+ *---------------------------------------------------------------*/
+namespace validate
+{
+
+constexpr std::size_t kChunkWork = std::size_t{1} << 16;
+
+enum class Mode { First, All };
+
+struct Conflict
+{
+    int u, v;                               // u < v, ребро
+    int colour;
+};
+
+struct Report
+{
+    bool sizeOk     = true;                 // |color| == n
+    int  uncoloured = 0;                    // вершин с цветом < base
+    int  colours    = 0;                    // различных цветов ≥ base
+    int  maxColour  = -1;                   // наибольший цвет (−1 — нет)
+    bool contiguous = true;                 // использованы ровно base … base+colours−1
+    std::vector<Conflict> conflicts;        // по (u, v); в Mode::First — не больше одного
+
+    bool ok() const { return sizeOk && uncoloured == 0 && conflicts.empty(); }
+};
+
+namespace detail
+{
+
+/* размер, неокрашенные, число цветов и сплошность нумерации */
+inline Report summarize(std::size_t n, const std::vector<int>& color, int base)
+{
+    Report r;
+    if (color.size() != n) {
+        r.sizeOk = false;
+        return r;
+    }
+    std::vector<char> used(n, 0);
+    std::vector<int>  outliers;             // цвета ≥ base + n: сплошными быть не могут
+    for (int c : color) {
+        if (c < base) { ++r.uncoloured; continue; }
+        r.maxColour = std::max(r.maxColour, c);
+        const auto k = static_cast<std::size_t>(static_cast<long long>(c) - base);
+        if (k < n) used[k] = 1;
+        else       outliers.push_back(c);
+    }
+    std::size_t top = 0;                    // used[0 … top) — сплошной префикс
+    while (top < n && used[top]) ++top;
+    for (std::size_t k = 0; k < n; ++k) r.colours += used[k];
+    std::sort(outliers.begin(), outliers.end());
+    r.colours   += static_cast<int>(std::unique(outliers.begin(), outliers.end()) - outliers.begin());
+    r.contiguous = outliers.empty() && static_cast<int>(top) == r.colours;
+    return r;
+}
+
+/* v ← min(v, x) */
+inline void atomicMin(std::atomic<std::uint64_t>& v, std::uint64_t x)
+{
+    std::uint64_t cur = v.load(std::memory_order_relaxed);
+    while (x < cur && !v.compare_exchange_weak(cur, x, std::memory_order_relaxed)) {}
+}
+
+inline std::uint64_t key(int u, int v)
+{
+    return (static_cast<std::uint64_t>(u) << 32) | static_cast<std::uint32_t>(v);
+}
+
+/*
+ * Общий драйвер: границы блоков bounds[0] = 0 < … < bounds.back() = n,
+ * scan(first, last, out, stopAt) — конфликты вершин [first, last) по
+ * возрастанию (u, v); в Mode::First scan прекращает работу на первом
+ * конфликте или когда очередная u правее stopAt().
+ */
+template<class Scan>
+void run(const std::vector<int>& bounds, Mode mode, unsigned threads, Report& r, Scan&& scan)
+{
+    const std::size_t chunks = bounds.size() - 1;
+    std::vector<std::vector<Conflict>> found(chunks);
+    std::atomic<std::uint64_t> first{UINT64_MAX};
+
+    auto work = [&](std::size_t k) {
+        if (mode == Mode::First &&
+            key(bounds[k], 0) > first.load(std::memory_order_relaxed)) return;
+        scan(bounds[k], bounds[k + 1], found[k], [&]{ return first.load(std::memory_order_relaxed); });
+        if (mode == Mode::First && !found[k].empty())
+            atomicMin(first, key(found[k][0].u, found[k][0].v));
+    };
+
+    if (threads == 1 || chunks < 2) {
+        for (std::size_t k = 0; k < chunks; ++k) work(k);
+    } else {
+        WorkStealingPool pool(threads);
+        for (std::size_t k = chunks; k-- > 0; )      // ранние блоки — первыми (LIFO)
+            pool.submit([&work, k]{ work(k); });
+        pool.wait();
+    }
+
+    for (auto& f : found) {
+        if (mode == Mode::First && !f.empty()) {    // блоки по возрастанию u
+            r.conflicts.push_back(f[0]);
+            return;
+        }
+        r.conflicts.insert(r.conflicts.end(), f.begin(), f.end());
+    }
+}
+
+/* ∃ k ∈ [from, to): a[k] ∧ b[k] ≠ 0 — блоками по кэш-линии */
+inline bool anyAnd(const bits::Word* a, const bits::Word* b, int from, int to)
+{
+    for (int k = from; k < to; k += bits::kWordsPerLine) {
+        const int e = std::min(k + bits::kWordsPerLine, to);
+        bits::Word acc = 0;
+        for (int i = k; i < e; ++i) acc |= a[i] & b[i];
+        if (acc) return true;
+    }
+    return false;
+}
+
+} // namespace detail
+
+/*-------- CSR: рёбра блоками равной суммы степеней -------------*/
+inline Report check(const CsrGraph& g, const std::vector<int>& color, int base = 0,
+                    Mode mode = Mode::First, unsigned threads = 0)
+{
+    const std::size_t n = g.size();
+    Report r = detail::summarize(n, color, base);
+    if (!r.sizeOk || n == 0) return r;
+
+    const CsrGraph::Offset* off = g.offsetData();
+    const CsrGraph::Vertex* adj = g.neighbourData();
+
+    std::vector<int> bounds{0};
+    for (std::size_t v = 0; v < n; ) {
+        const CsrGraph::Offset goal = off[v] + kChunkWork;
+        std::size_t next = static_cast<std::size_t>(
+            std::upper_bound(off + v + 1, off + n + 1, goal) - off) - 1;
+        next = std::max(next, v + 1);
+        bounds.push_back(static_cast<int>(next));
+        v = next;
+    }
+
+    detail::run(bounds, mode, threads, r,
+        [&](int first, int last, std::vector<Conflict>& out, auto&& stopAt) {
+            for (int u = first; u < last; ++u) {
+                if (mode == Mode::First && detail::key(u, 0) > stopAt()) return;
+                const int cu = color[u];
+                if (cu < base) continue;
+                /* соседи отсортированы: сразу к v > u */
+                const CsrGraph::Vertex* p = std::upper_bound(adj + off[u], adj + off[u + 1],
+                                                             static_cast<CsrGraph::Vertex>(u));
+                for (; p != adj + off[u + 1]; ++p)
+                    if (color[*p] == cu) {
+                        out.push_back({u, static_cast<int>(*p), cu});
+                        if (mode == Mode::First) return;
+                    }
+            }
+        });
+    return r;
+}
+
+/*-------- упакованные строки: rows[v·stride …], n бит в строке ---*/
+inline Report checkPacked(int n, const bits::Word* rows, int stride,
+                          const std::vector<int>& color, int base = 0,
+                          Mode mode = Mode::First, unsigned threads = 0)
+{
+    Report r = detail::summarize(static_cast<std::size_t>(std::max(n, 0)), color, base);
+    if (!r.sizeOk || n <= 0 || r.colours == 0) return r;   // нет окрашенных — нет и конфликтов
+    const int W = bits::wordsFor(n);
+
+    /* номер класса: цвет − base, а при цветах вне [base, base+n) — сжатый */
+    std::vector<int> cls(n, -1);
+    int classes = 0;
+    if (r.maxColour - static_cast<long long>(base) < n) {
+        for (int v = 0; v < n; ++v) if (color[v] >= base) cls[v] = color[v] - base;
+        classes = r.maxColour - base + 1;
+    } else {
+        std::vector<int> values;
+        for (int c : color) if (c >= base) values.push_back(c);
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        for (int v = 0; v < n; ++v)
+            if (color[v] >= base)
+                cls[v] = static_cast<int>(std::lower_bound(values.begin(), values.end(), color[v]) -
+                                          values.begin());
+        classes = static_cast<int>(values.size());
+    }
+    const int cstride = bits::strideFor(n);
+    bits::WordVector classRows(static_cast<std::size_t>(classes) * cstride, 0);
+    for (int v = 0; v < n; ++v)
+        if (cls[v] >= 0) bits::set(classRows.data() + static_cast<std::size_t>(cls[v]) * cstride, v);
+
+    /* стоимость строки v — слова правее v: блоки по kChunkWork слов */
+    std::vector<int> bounds{0};
+    std::size_t acc = 0;
+    for (int v = 0; v < n; ++v) {
+        acc += static_cast<std::size_t>(W - (v >> 6));
+        if (acc >= kChunkWork && v + 1 < n) { bounds.push_back(v + 1); acc = 0; }
+    }
+    bounds.push_back(n);
+
+    detail::run(bounds, mode, threads, r,
+        [&](int first, int last, std::vector<Conflict>& out, auto&& stopAt) {
+            for (int u = first; u < last; ++u) {
+                if (mode == Mode::First && detail::key(u, 0) > stopAt()) return;
+                if (cls[u] < 0) continue;
+                const bits::Word* a = rows + static_cast<std::size_t>(u) * stride;
+                const bits::Word* b = classRows.data() + static_cast<std::size_t>(cls[u]) * cstride;
+
+                /* слово с самой u: только биты старше u */
+                const int w0 = u >> 6;
+                const bits::Word hi = (u & 63) == 63 ? 0 : ~bits::Word{0} << ((u & 63) + 1);
+                bool hit = (a[w0] & b[w0] & hi) != 0;
+                if (!hit) hit = detail::anyAnd(a, b, w0 + 1, W);
+                if (!hit) continue;
+
+                for (int k = w0; k < W; ++k)
+                    for (bits::Word x = a[k] & b[k] & (k == w0 ? hi : ~bits::Word{0}); x; x &= x - 1) {
+                        out.push_back({u, k * bits::kWordBits + bits::ctz64(x), color[u]});
+                        if (mode == Mode::First) return;
+                    }
+            }
+        });
+    return r;
+}
+
+inline Report check(const Graph& g, const std::vector<int>& color, int base = 0,
+                    Mode mode = Mode::First, unsigned threads = 0)
+{
+    return checkPacked(g.size(), g.size() ? g.adjRow(0) : nullptr, g.stride(),
+                       color, base, mode, threads);
+}
+
+} // namespace validate
@@ -0,0 +1,183 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*---------------------------------------------------------------*
+ |  CsrGraph — неизменяемый неориентированный граф в формате CSR  |
+ |                                                                |
+ |  offsets[v] … offsets[v+1] — диапазон соседей v в neighbours;  |
+ |  номера 32-битные, списки отсортированы, без повторов и петель,|
+ |  каждое ребро хранится в обоих направлениях.                   |
+ |                                                                |
+ |  Данные лежат в общем хранилище (shared_ptr), поэтому копия    |
+ |  графа — это два указателя и счётчик ссылок. Хранилищем может  |
+ |  быть и чужая память (например, отображённый файл) — см. view. |
+ |                                                                |
+ |  Плотные матрицы приводятся к CSR один раз (fromDense); все    |
+ |  алгоритмы принимают CsrGraph, а перегрузки от матриц —        |
+ |  тонкие обёртки над ним.                                       |
+ *---------------------------------------------------------------*/
+class CsrGraph
+{
+public:
+    using Vertex = std::uint32_t;
+    using Offset = std::uint64_t;
+
+    /* диапазон соседей вершины */
+    struct Neighbours
+    {
+        const Vertex* first;
+        const Vertex* last;
+
+        const Vertex* begin() const { return first; }
+        const Vertex* end()   const { return last; }
+        std::size_t   size()  const { return static_cast<std::size_t>(last - first); }
+        bool          empty() const { return first == last; }
+    };
+
+    CsrGraph() = default;
+
+    /* готовые массивы: offsets.size() == n + 1, списки уже
+       отсортированы, симметричны и без повторов               */
+    CsrGraph(std::vector<Offset> offsets, std::vector<Vertex> neighbours)
+    {
+        if (offsets.empty() || offsets.back() != neighbours.size())
+            throw std::runtime_error("CsrGraph: offsets do not match neighbours");
+        auto storage = std::make_shared<Storage>();
+        storage->offsets    = std::move(offsets);
+        storage->neighbours = std::move(neighbours);
+        n_       = storage->offsets.size() - 1;
+        offsets_ = storage->offsets.data();
+        adj_     = storage->neighbours.data();
+        owner_   = std::move(storage);
+    }
+
+    /* граф поверх чужой памяти; owner держит её живой */
+    static CsrGraph view(std::size_t n, const Offset* offsets, const Vertex* neighbours,
+                         std::shared_ptr<const void> owner)
+    {
+        CsrGraph g;
+        g.n_       = n;
+        g.offsets_ = offsets;
+        g.adj_     = neighbours;
+        g.owner_   = std::move(owner);
+        return g;
+    }
+
+    /* из списка рёбер: симметризация, без петель, сортировка, без повторов */
+    static CsrGraph fromEdges(std::size_t n,
+                              const std::vector<std::pair<Vertex, Vertex>>& edges)
+    {
+        std::vector<Offset> offsets(n + 1, 0);
+        for (const auto& [u, v] : edges) {
+            if (u >= n || v >= n) throw std::runtime_error("CsrGraph: vertex out of range");
+            if (u == v) continue;
+            ++offsets[u + 1];
+            ++offsets[v + 1];
+        }
+        for (std::size_t v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+
+        std::vector<Vertex> adj(offsets[n]);
+        std::vector<Offset> fill(offsets.begin(), offsets.end() - 1);
+        for (const auto& [u, v] : edges) {
+            if (u == v) continue;
+            adj[fill[u]++] = v;
+            adj[fill[v]++] = u;
+        }
+        return compact(std::move(offsets), std::move(adj));
+    }
+
+    /* из списков смежности (достаточно одного направления) */
+    static CsrGraph fromAdjacency(const std::vector<std::vector<int>>& lists)
+    {
+        std::vector<std::pair<Vertex, Vertex>> edges;
+        for (std::size_t v = 0; v < lists.size(); ++v)
+            for (int u : lists[v])
+                edges.emplace_back(static_cast<Vertex>(v), static_cast<Vertex>(u));
+        return fromEdges(lists.size(), edges);
+    }
+
+    /* из 0/1-матрицы: ребро, если M(i,j) != 0 или M(j,i) != 0 */
+    template<class Matrix>
+    static CsrGraph fromDense(const Matrix& M)
+    {
+        const std::size_t n = static_cast<std::size_t>(M.rows());
+        std::vector<Offset> offsets(n + 1, 0);
+        std::vector<Vertex> adj;
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j)
+                if (i != j && (M(i, j) || M(j, i))) adj.push_back(static_cast<Vertex>(j));
+            offsets[i + 1] = adj.size();
+        }
+        return CsrGraph(std::move(offsets), std::move(adj));
+    }
+
+    /* списки в offsets/adj (симметричные, без петель) ещё не
+       отсортированы и могут повторяться: сортировка и удаление
+       повторов на месте                                          */
+    static CsrGraph compact(std::vector<Offset> offsets, std::vector<Vertex> adj)
+    {
+        const std::size_t n = offsets.size() - 1;
+        Offset out = 0;
+        for (std::size_t v = 0; v < n; ++v) {
+            const Offset b = offsets[v], e = offsets[v + 1];
+            std::sort(adj.begin() + b, adj.begin() + e);
+            const Offset start = out;
+            for (Offset k = b; k < e; ++k)
+                if (out == start || adj[out - 1] != adj[k]) adj[out++] = adj[k];
+            offsets[v] = start;
+        }
+        offsets[n] = out;
+        adj.resize(out);
+        adj.shrink_to_fit();
+        return CsrGraph(std::move(offsets), std::move(adj));
+    }
+
+    std::size_t size()  const { return n_; }                      // |V|
+    std::size_t edges() const { return n_ ? offsets_[n_] / 2 : 0; } // |E|
+
+    std::size_t degree(std::size_t v) const
+    {
+        return static_cast<std::size_t>(offsets_[v + 1] - offsets_[v]);
+    }
+
+    Neighbours neighbours(std::size_t v) const
+    {
+        return { adj_ + offsets_[v], adj_ + offsets_[v + 1] };
+    }
+
+    // u и v смежны? (двоичный поиск по списку меньшей степени)
+    bool areAdjacent(std::size_t u, std::size_t v) const
+    {
+        if (degree(u) > degree(v)) std::swap(u, v);
+        const auto nb = neighbours(u);
+        return std::binary_search(nb.begin(), nb.end(), static_cast<Vertex>(v));
+    }
+
+    std::size_t maxDegree() const
+    {
+        std::size_t d = 0;
+        for (std::size_t v = 0; v < n_; ++v) d = std::max(d, degree(v));
+        return d;
+    }
+
+    const Offset* offsetData()    const { return offsets_; }
+    const Vertex* neighbourData() const { return adj_; }
+
+private:
+    struct Storage
+    {
+        std::vector<Offset> offsets;
+        std::vector<Vertex> neighbours;
+    };
+
+    std::size_t                 n_       = 0;
+    const Offset*               offsets_ = nullptr;
+    const Vertex*               adj_     = nullptr;
+    std::shared_ptr<const void> owner_;
+};
@@ -0,0 +1,336 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#  include <iterator>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#include "CsrGraph.h"
+#include "method/Bitset.h"
+
+/*---------------------------------------------------------------*
+ |  Двоичный контейнер графов (.ogb) с загрузкой через mmap       |
+ |                                                                |
+ |  Файл (порядок байт — родной, 64-битные смещения от начала):   |
+ |                                                                |
+ |    BinaryFileHeader                       64 байта             |
+ |    раздел графа 0, 1, …  (каждый с границы 64 байт):           |
+ |      BinaryGraphHeader                    64 байта             |
+ |      offsets     uint64 × (n+1)                                |
+ |      neighbours  uint32 × offsets[n]                           |
+ |      dense       Word × n·strideFor(n)   (если kHasDense)      |
+ |    каталог: uint64 × count — смещения разделов                 |
+ |                                                                |
+ |  Читатель только отображает файл и проверяет границы           |
+ |  разделов: CsrGraph и упакованные строки указывают прямо в     |
+ |  отображение, разбора нет. Отображение живёт, пока жив хоть    |
+ |  один полученный из него граф.                                 |
+ |                                                                |
+ |  Содержимое offsets/neighbours по умолчанию не проверяется     |
+ |  (это проход O(n+m) по всему файлу); с verify = true каждый    |
+ |  раздел проверяется целиком — для файлов из чужих рук.         |
+ *---------------------------------------------------------------*/
+namespace graphio
+{
+
+constexpr std::uint32_t kBinaryMagic   = 0x3142474F;   // "OGB1"
+constexpr std::uint32_t kBinaryVersion = 1;
+constexpr std::uint64_t kBinaryAlign   = 64;
+
+enum BinaryFlags : std::uint32_t
+{
+    kHasDense     = 1u << 0,        // упакованные строки смежности
+    kHasDensity   = 1u << 1,
+    kHasChromatic = 1u << 2,        // известное χ
+};
+
+struct BinaryFileHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t count;            // графов в файле
+    std::uint64_t directory;        // смещение каталога
+    std::uint64_t reserved[5];
+};
+
+struct BinaryGraphHeader
+{
+    std::uint64_t n;
+    std::uint64_t adjCount;         // = offsets[n] = 2|E|
+    std::uint32_t flags;
+    std::int32_t  chromatic;        // -1 — неизвестно
+    double        density;
+    std::uint64_t offsetsAt, neighboursAt, denseAt;
+    std::uint32_t denseStride;      // слов в строке dense
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(BinaryFileHeader)  == 64, "BinaryFileHeader layout");
+static_assert(sizeof(BinaryGraphHeader) == 64, "BinaryGraphHeader layout");
+
+/* граф из контейнера: CSR и метаданные */
+struct StoredGraph
+{
+    CsrGraph          graph;
+    double            density   = -1.0;     // < 0 — неизвестна
+    int               chromatic = -1;       // < 0 — неизвестно
+    const bits::Word* dense     = nullptr;  // строки по denseStride слов или nullptr
+    int               denseStride = 0;
+};
+
+/*-------- запись -----------------------------------------------*/
+class BinaryGraphWriter
+{
+public:
+    explicit BinaryGraphWriter(const std::string& fileName)
+        : fileName_(fileName), out_(fileName, std::ios::binary | std::ios::trunc)
+    {
+        if (!out_) throw std::runtime_error("Cannot open " + fileName);
+        BinaryFileHeader h{};
+        write(&h, sizeof h);                    // заполним в close()
+    }
+
+    ~BinaryGraphWriter()
+    {
+        try { close(); } catch (...) {}
+    }
+
+    BinaryGraphWriter(const BinaryGraphWriter&)            = delete;
+    BinaryGraphWriter& operator=(const BinaryGraphWriter&) = delete;
+
+    // density < 0 и chromatic < 0 — «неизвестно»; dense — добавить битовые строки
+    void add(const CsrGraph& g, double density = -1.0, int chromatic = -1, bool dense = false)
+    {
+        const std::size_t n = g.size();
+        BinaryGraphHeader h{};
+        h.n         = n;
+        h.adjCount  = n ? g.offsetData()[n] : 0;
+        h.flags     = (density >= 0 ? std::uint32_t(kHasDensity) : 0u) |
+                      (chromatic >= 0 ? std::uint32_t(kHasChromatic) : 0u) |
+                      (dense ? std::uint32_t(kHasDense) : 0u);
+        h.chromatic = chromatic;
+        h.density   = density;
+
+        const std::uint64_t at = align();
+        sections_.push_back(at);
+        write(&h, sizeof h);
+
+        h.offsetsAt = align();
+        if (n) write(g.offsetData(), (n + 1) * sizeof(CsrGraph::Offset));
+        else { const CsrGraph::Offset zero = 0; write(&zero, sizeof zero); }
+        h.neighboursAt = align();
+        if (h.adjCount) write(g.neighbourData(), h.adjCount * sizeof(CsrGraph::Vertex));
+
+        if (dense) {
+            h.denseStride = static_cast<std::uint32_t>(bits::strideFor(static_cast<int>(n)));
+            h.denseAt     = align();
+            bits::WordVector row(h.denseStride);
+            for (std::size_t v = 0; v < n; ++v) {
+                std::fill(row.begin(), row.end(), 0);
+                for (auto u : g.neighbours(v)) bits::set(row.data(), static_cast<int>(u));
+                write(row.data(), row.size() * sizeof(bits::Word));
+            }
+        }
+
+        /* заголовок раздела — теперь со смещениями */
+        const auto end = out_.tellp();
+        out_.seekp(static_cast<std::streamoff>(at));
+        write(&h, sizeof h);
+        out_.seekp(end);
+    }
+
+    // каталог и заголовок файла; повторный вызов ничего не делает
+    void close()
+    {
+        if (!out_.is_open()) return;
+        BinaryFileHeader h{};
+        h.magic     = kBinaryMagic;
+        h.version   = kBinaryVersion;
+        h.count     = sections_.size();
+        h.directory = align();
+        write(sections_.data(), sections_.size() * sizeof(std::uint64_t));
+        out_.seekp(0);
+        write(&h, sizeof h);
+        out_.close();
+        if (!out_) throw std::runtime_error("Write failed: " + fileName_);
+    }
+
+private:
+    std::string                fileName_;
+    std::ofstream              out_;
+    std::vector<std::uint64_t> sections_;
+
+    void write(const void* p, std::size_t bytes)
+    {
+        out_.write(static_cast<const char*>(p), static_cast<std::streamsize>(bytes));
+        if (!out_) throw std::runtime_error("Write failed: " + fileName_);
+    }
+
+    std::uint64_t align()
+    {
+        static const char zeros[kBinaryAlign] = {};
+        const auto pos = static_cast<std::uint64_t>(out_.tellp());
+        const std::uint64_t pad = (kBinaryAlign - pos % kBinaryAlign) % kBinaryAlign;
+        write(zeros, pad);
+        return pos + pad;
+    }
+};
+
+inline void writeBinaryGraph(const std::string& fileName, const CsrGraph& g,
+                             double density = -1.0, int chromatic = -1, bool dense = false)
+{
+    BinaryGraphWriter w(fileName);
+    w.add(g, density, chromatic, dense);
+    w.close();
+}
+
+/*-------- файл целиком в памяти: mmap (на Windows — копия) -----*/
+struct MappedFile
+{
+    const char* data = nullptr;
+    std::size_t size = 0;
+#if defined(_WIN32)
+    std::vector<char> bytes;
+
+    explicit MappedFile(const std::string& fileName)
+    {
+        std::ifstream in(fileName, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open " + fileName);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+        data = bytes.data();
+        size = bytes.size();
+    }
+#else
+    explicit MappedFile(const std::string& fileName)
+    {
+        const int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + fileName);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) { ::close(fd); throw std::runtime_error("Cannot stat " + fileName); }
+        size = static_cast<std::size_t>(st.st_size);
+        if (size) {
+            void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) { ::close(fd); throw std::runtime_error("Cannot mmap " + fileName); }
+            data = static_cast<const char*>(p);
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if (data) ::munmap(const_cast<char*>(data), size);
+    }
+#endif
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+/*-------- чтение: отображение файла ----------------------------*/
+class BinaryGraphFile
+{
+public:
+    // verify — проверять содержимое каждого раздела (O(n+m)), см. check()
+    explicit BinaryGraphFile(const std::string& fileName, bool verify = false)
+        : fileName_(fileName), map_(std::make_shared<MappedFile>(fileName)), verify_(verify)
+    {
+        if (map_->size < sizeof(BinaryFileHeader)) fail("Not a binary graph file");
+        const auto& h = *reinterpret_cast<const BinaryFileHeader*>(map_->data);
+        if (h.magic != kBinaryMagic)     fail("Not a binary graph file");
+        if (h.version != kBinaryVersion) fail("Unsupported binary graph version");
+        if (h.directory % alignof(std::uint64_t) ||
+            !inside(h.directory, h.count, sizeof(std::uint64_t))) fail("Corrupt directory");
+        count_     = static_cast<std::size_t>(h.count);
+        directory_ = reinterpret_cast<const std::uint64_t*>(map_->data + h.directory);
+    }
+
+    std::size_t size() const { return count_; }
+
+    StoredGraph operator[](std::size_t i) const
+    {
+        if (i >= count_) throw std::out_of_range("Graph index out of range in " + fileName_);
+        const std::uint64_t at = directory_[i];
+        if (at % kBinaryAlign || !inside(at, 1, sizeof(BinaryGraphHeader))) fail("Corrupt section");
+        const auto& h = *reinterpret_cast<const BinaryGraphHeader*>(map_->data + at);
+
+        if (h.n >= UINT32_MAX ||
+            h.offsetsAt % alignof(CsrGraph::Offset) || h.neighboursAt % alignof(CsrGraph::Vertex) ||
+            !inside(h.offsetsAt, h.n + 1, sizeof(CsrGraph::Offset)) ||
+            !inside(h.neighboursAt, h.adjCount, sizeof(CsrGraph::Vertex)))
+            fail("Corrupt section");
+        const auto* offsets = reinterpret_cast<const CsrGraph::Offset*>(map_->data + h.offsetsAt);
+        const auto* adj     = reinterpret_cast<const CsrGraph::Vertex*>(map_->data + h.neighboursAt);
+        if (offsets[0] != 0 || offsets[h.n] != h.adjCount) fail("Corrupt section");
+        if (verify_) check(h, offsets, adj);
+
+        StoredGraph s;
+        s.graph = CsrGraph::view(static_cast<std::size_t>(h.n), offsets, adj, map_);
+        if (h.flags & kHasDensity)   s.density   = h.density;
+        if (h.flags & kHasChromatic) s.chromatic = h.chromatic;
+        if (h.flags & kHasDense) {
+            if (h.denseStride != static_cast<std::uint32_t>(bits::strideFor(static_cast<int>(h.n))) ||
+                h.denseAt % kBinaryAlign || !inside(h.denseAt, h.n * h.denseStride, sizeof(bits::Word)))
+                fail("Corrupt section");
+            s.dense       = reinterpret_cast<const bits::Word*>(map_->data + h.denseAt);
+            s.denseStride = static_cast<int>(h.denseStride);
+        }
+        return s;
+    }
+
+private:
+    std::string                       fileName_;
+    std::shared_ptr<const MappedFile> map_;
+    std::size_t                       count_     = 0;
+    const std::uint64_t*              directory_ = nullptr;
+    bool                              verify_    = false;
+
+    [[noreturn]] void fail(const char* what) const
+    {
+        throw std::runtime_error(std::string(what) + " in " + fileName_);
+    }
+
+    /* инварианты CsrGraph: смещения не убывают, соседи строки — номера
+       вершин < n по возрастанию, без петель. Иначе neighbours() читает
+       за концом раздела, а areAdjacent() (двоичный поиск) врёт.      */
+    void check(const BinaryGraphHeader& h, const CsrGraph::Offset* offsets,
+               const CsrGraph::Vertex* adj) const
+    {
+        for (std::uint64_t v = 0; v < h.n; ++v) {
+            const std::uint64_t from = offsets[v], to = offsets[v + 1];
+            if (from > to || to > h.adjCount) fail("Corrupt offsets");
+            for (std::uint64_t k = from; k < to; ++k) {
+                const std::uint64_t u = adj[k];
+                if (u >= h.n || u == v || (k > from && adj[k - 1] >= u)) fail("Corrupt neighbours");
+            }
+        }
+    }
+
+    // [at, at + count·elem) внутри файла, без переполнения
+    bool inside(std::uint64_t at, std::uint64_t count, std::uint64_t elem) const
+    {
+        const std::uint64_t size = map_->size;
+        return at <= size && count <= (size - at) / elem;
+    }
+};
+
+/* первый граф файла (отображение держит сам граф) */
+inline StoredGraph readBinaryGraph(const std::string& fileName, bool verify = false)
+{
+    BinaryGraphFile f(fileName, verify);
+    if (f.size() == 0) throw std::runtime_error("No graphs in " + fileName);
+    return f[0];
+}
+
+} // namespace graphio
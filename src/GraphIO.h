@@ -0,0 +1,235 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "CsrGraph.h"
+
+/*---------------------------------------------------------------*
+ |  Потоковое чтение разреженных графов сразу в CsrGraph          |
+ |                                                                |
+ |   • DIMACS .col:  "c …" — комментарий, "p edge N M" — заголовок,|
+ |                   "e u v" — ребро (номера с 1);                 |
+ |   • список рёбер: "u v" в строке (номера с base, по умолчанию  |
+ |                   0), "#" и "%" — комментарии, лишние столбцы   |
+ |                   (веса) пропускаются.                          |
+ |                                                                |
+ |  Матрица n×n не строится. Файл читается блоками фиксированного |
+ |  размера дважды: первый проход считает степени, второй пишет   |
+ |  соседей прямо на их места в CSR. Памяти — сам CSR плюс блок.  |
+ |  Петли отбрасываются, повторные рёбра схлопываются.            |
+ |  Ошибка формата — runtime_error с номером строки.              |
+ *---------------------------------------------------------------*/
+namespace graphio
+{
+
+constexpr std::size_t kDefaultChunk = std::size_t{1} << 20;   // 1 MiB
+
+/*-------- построчное чтение блоками ----------------------------*/
+class LineReader
+{
+public:
+    explicit LineReader(const std::string& fileName, std::size_t chunk = kDefaultChunk)
+        : fileName_(fileName), in_(fileName, std::ios::binary), buf_(chunk)
+    {
+        if (!in_) throw std::runtime_error("Cannot open " + fileName);
+    }
+
+    const std::string& fileName() const { return fileName_; }
+
+    // f(first, last, lineNo) для каждой строки файла (без '\n' и '\r'),
+    // каждый вызов — новый проход с начала файла
+    template<class F>
+    void forEachLine(F&& f)
+    {
+        in_.clear();
+        in_.seekg(0);
+        std::size_t   carry  = 0;             // начало незаконченной строки
+        std::uint64_t lineNo = 0;
+        auto emit = [&](const char* b, const char* e) {
+            if (e > b && e[-1] == '\r') --e;
+            f(b, e, ++lineNo);
+        };
+
+        for (;;) {
+            in_.read(buf_.data() + carry, static_cast<std::streamsize>(buf_.size() - carry));
+            const std::size_t got = static_cast<std::size_t>(in_.gcount());
+            const char* p    = buf_.data();
+            const char* last = buf_.data() + carry + got;
+
+            while (const char* nl = static_cast<const char*>(std::memchr(p, '\n', last - p))) {
+                emit(p, nl);
+                p = nl + 1;
+            }
+            carry = static_cast<std::size_t>(last - p);
+            if (got == 0) {                     // конец файла
+                if (carry) emit(p, last);
+                return;
+            }
+            if (carry == buf_.size())
+                throw std::runtime_error("Line too long in " + fileName_);
+            std::memmove(buf_.data(), p, carry);
+        }
+    }
+
+private:
+    std::string       fileName_;
+    std::ifstream     in_;
+    std::vector<char> buf_;
+};
+
+namespace detail
+{
+
+inline void skipSpace(const char*& p, const char* e)
+{
+    while (p < e && (*p == ' ' || *p == '\t')) ++p;
+}
+
+inline bool parseId(const char*& p, const char* e, std::uint64_t& out)
+{
+    skipSpace(p, e);
+    const auto r = std::from_chars(p, e, out);
+    if (r.ec != std::errc() || (r.ptr < e && *r.ptr != ' ' && *r.ptr != '\t')) return false;
+    p = r.ptr;
+    return true;
+}
+
+[[noreturn]] inline void badLine(const char* what, std::uint64_t lineNo,
+                                 const std::string& fileName)
+{
+    throw std::runtime_error(std::string("Bad ") + what + " line " +
+                             std::to_string(lineNo) + " in " + fileName);
+}
+
+/* второй проход: соседи на свои места, затем сортировка/повторы */
+template<class ForEachEdge>
+CsrGraph fill(std::vector<CsrGraph::Offset> offsets, ForEachEdge&& forEachEdge)
+{
+    const std::size_t n = offsets.size() - 1;
+    for (std::size_t v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+
+    std::vector<CsrGraph::Vertex> adj(offsets[n]);
+    std::vector<CsrGraph::Offset> pos(offsets.begin(), offsets.end() - 1);
+    forEachEdge([&](CsrGraph::Vertex u, CsrGraph::Vertex v) {
+        adj[pos[u]++] = v;
+        adj[pos[v]++] = u;
+    });
+    return CsrGraph::compact(std::move(offsets), std::move(adj));
+}
+
+} // namespace detail
+
+/*-------- DIMACS .col ------------------------------------------*/
+inline CsrGraph readDimacs(const std::string& fileName, std::size_t chunk = kDefaultChunk)
+{
+    LineReader in(fileName, chunk);
+    std::size_t n = 0;
+    bool header = false;
+
+    /* разбор строки: true — строка ребра (u, v), 0-based */
+    auto edge = [&](const char* p, const char* e, std::uint64_t lineNo,
+                    CsrGraph::Vertex& u, CsrGraph::Vertex& v) -> bool {
+        detail::skipSpace(p, e);
+        if (p == e || *p == 'c' || *p == 'n' || *p == 'x') return false;   // комментарии, доп. строки
+        if (*p == 'p') return false;
+        if (*p != 'e') detail::badLine("DIMACS", lineNo, fileName);
+
+        std::uint64_t a, b;
+        ++p;
+        if (!header || !detail::parseId(p, e, a) || !detail::parseId(p, e, b) ||
+            a < 1 || b < 1 || a > n || b > n)
+            detail::badLine("DIMACS", lineNo, fileName);
+        u = static_cast<CsrGraph::Vertex>(a - 1);
+        v = static_cast<CsrGraph::Vertex>(b - 1);
+        return true;
+    };
+
+    /* ---------- проход 1: заголовок и степени ---------- */
+    std::vector<CsrGraph::Offset> offsets;
+    in.forEachLine([&](const char* p, const char* e, std::uint64_t lineNo) {
+        detail::skipSpace(p, e);
+        if (p < e && *p == 'p') {
+            /* p edge N M  (формат — любое слово: edge, col, …) */
+            ++p;
+            detail::skipSpace(p, e);
+            while (p < e && *p != ' ' && *p != '\t') ++p;
+            std::uint64_t nn;
+            if (header || !detail::parseId(p, e, nn) || nn > UINT32_MAX)
+                detail::badLine("DIMACS", lineNo, fileName);
+            header = true;
+            n = static_cast<std::size_t>(nn);
+            offsets.assign(n + 1, 0);
+            return;
+        }
+        CsrGraph::Vertex u, v;
+        if (edge(p, e, lineNo, u, v) && u != v) { ++offsets[u + 1]; ++offsets[v + 1]; }
+    });
+    if (!header) throw std::runtime_error("Missing DIMACS header (p edge N M) in " + fileName);
+
+    /* ---------- проход 2: соседи ---------- */
+    return detail::fill(std::move(offsets), [&](auto&& add) {
+        in.forEachLine([&](const char* p, const char* e, std::uint64_t lineNo) {
+            CsrGraph::Vertex u, v;
+            if (edge(p, e, lineNo, u, v) && u != v) add(u, v);
+        });
+    });
+}
+
+/*-------- список рёбер -----------------------------------------*/
+inline CsrGraph readEdgeList(const std::string& fileName, unsigned base = 0,
+                             std::size_t chunk = kDefaultChunk)
+{
+    LineReader in(fileName, chunk);
+
+    auto edge = [&](const char* p, const char* e, std::uint64_t lineNo,
+                    CsrGraph::Vertex& u, CsrGraph::Vertex& v) -> bool {
+        detail::skipSpace(p, e);
+        if (p == e || *p == '#' || *p == '%') return false;
+
+        std::uint64_t a, b;
+        if (!detail::parseId(p, e, a) || !detail::parseId(p, e, b) ||
+            a < base || b < base || a - base >= UINT32_MAX || b - base >= UINT32_MAX)
+            detail::badLine("edge list", lineNo, fileName);
+        u = static_cast<CsrGraph::Vertex>(a - base);
+        v = static_cast<CsrGraph::Vertex>(b - base);
+        return true;
+    };
+
+    /* ---------- проход 1: степени, n = max номер + 1 ---------- */
+    std::vector<CsrGraph::Offset> offsets(1, 0);
+    in.forEachLine([&](const char* p, const char* e, std::uint64_t lineNo) {
+        CsrGraph::Vertex u, v;
+        if (!edge(p, e, lineNo, u, v)) return;
+
+        const std::size_t need = static_cast<std::size_t>(std::max(u, v)) + 2;
+        if (offsets.size() < need) offsets.resize(need, 0);     // петля тоже задаёт n
+        if (u != v) { ++offsets[u + 1]; ++offsets[v + 1]; }
+    });
+
+    /* ---------- проход 2: соседи ---------- */
+    return detail::fill(std::move(offsets), [&](auto&& add) {
+        in.forEachLine([&](const char* p, const char* e, std::uint64_t lineNo) {
+            CsrGraph::Vertex u, v;
+            if (edge(p, e, lineNo, u, v) && u != v) add(u, v);
+        });
+    });
+}
+
+/*-------- по расширению: .col/.clq — DIMACS, иначе список рёбер --*/
+inline CsrGraph readGraph(const std::string& fileName)
+{
+    auto endsWith = [&](const char* ext) {
+        const std::size_t k = std::strlen(ext);
+        return fileName.size() >= k && fileName.compare(fileName.size() - k, k, ext) == 0;
+    };
+    if (endsWith(".col") || endsWith(".clq")) return readDimacs(fileName);
+    return readEdgeList(fileName);
+}
+
+} // namespace graphio
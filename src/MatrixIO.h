@@ -7,6 +7,13 @@
 #include <sstream>
 #include <cctype>
 #include <stdexcept>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+
+#include "CsrGraph.h"
+#include "GraphBinary.h"
+#include "WorkStealingPool.h"
 
 /*  Данные одного графа из файла */
 struct DenseGraph
@@ -117,6 +124,120 @@ inline std::vector<DenseGraph> loadGraphs(const std::string& fileName)
     return graphs;
 }
 
+/*------------------------------------------------------------------------
+   То же, что loadGraphs, но параллельно: файл отображается в память,
+   за один проход находятся начала графов (строки «n…»), и графы
+   разбираются на пуле из threads потоков (0 — по числу ядер).
+
+   Разбор строгий: n= и d= — целиком, элементы матрицы — целые токены
+   через from_chars. Всё, что выходит за «чистый» формат (дробные или
+   знаковые токены, мусор после n=, нехватка элементов, …), отдаётся
+   обычному loadGraphs: он даёт тот же результат или ту же ошибку.
+  ----------------------------------------------------------------------*/
+static inline void stripRange(const char*& b, const char*& e)   // как strip
+{
+    for (const char* p = b; p + 1 < e; ++p)
+        if (p[0] == '/' && p[1] == '/') { e = p; break; }
+    while (b < e && std::isspace(static_cast<unsigned char>(*b)))    ++b;
+    while (e > b && std::isspace(static_cast<unsigned char>(e[-1]))) --e;
+}
+
+/* один граф: [p, end) начинается со строки n=; false — нужен loadGraphs */
+static inline bool parseGraphStrict(const char* p, const char* end, DenseGraph& g)
+{
+    const char *lb, *le;
+    auto nextLine = [&]() {
+        if (p >= end) return false;
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        lb = p;
+        le = nl ? nl : end;
+        p  = nl ? nl + 1 : end;
+        stripRange(lb, le);
+        return true;
+    };
+    /* значение после '=' до конца строки */
+    auto valueAfterEq = [&](auto& out) {
+        const char* q = static_cast<const char*>(std::memchr(lb, '=', le - lb));
+        if (!q) return false;
+        for (++q; q < le && std::isspace(static_cast<unsigned char>(*q)); ++q) {}
+        const auto r = std::from_chars(q, le, out);
+        return r.ec == std::errc() && r.ptr == le;
+    };
+
+    /* ---------- параметры до matrix: ---------- */
+    bool matrix = false;
+    while (nextLine()) {
+        if (lb == le) continue;
+        if (*lb == 'n')      { if (!valueAfterEq(g.n))       return false; }
+        else if (*lb == 'd') { if (!valueAfterEq(g.density)) return false; }
+        else if (std::string(lb, le).find("matrix") != std::string::npos) { matrix = true; break; }
+    }
+    if (!matrix || g.n <= 0) return false;
+
+    /* ---------- матрица n×n ---------- */
+    auto numberChar = [](char ch) {
+        return std::isdigit(static_cast<unsigned char>(ch)) ||
+               ch=='+' || ch=='-' || ch=='.' || ch=='e' || ch=='E';
+    };
+    g.A = Eigen::MatrixXi::Zero(g.n, g.n);
+    const long long total = static_cast<long long>(g.n) * g.n;
+    long long read = 0;
+    while (read < total && nextLine()) {
+        const char* q = lb;
+        while (q < le && read < total) {
+            if (!numberChar(*q)) { ++q; continue; }     // разделитель
+            const char* t = q;
+            while (q < le && numberChar(*q)) ++q;
+            unsigned v;
+            const auto r = std::from_chars(t, q, v);
+            if (r.ec != std::errc() || r.ptr != q) return false;   // не целое без знака
+            g.A(read / g.n, read % g.n) = v != 0;
+            ++read;
+        }
+    }
+    return read == total;
+}
+
+inline std::vector<DenseGraph> loadGraphsParallel(const std::string& fileName,
+                                                  unsigned threads = 0)
+{
+    const graphio::MappedFile file(fileName);
+    const char* const begin = file.data;
+    const char* const end   = file.data + file.size;
+
+    /* ---------- начала графов: строки, начинающиеся с n ---------- */
+    std::vector<const char*> starts;
+    for (const char* p = begin; p < end; ) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* lb = p;
+        const char* le = nl ? nl : end;
+        stripRange(lb, le);
+        if (lb < le && *lb == 'n') starts.push_back(p);
+        p = nl ? nl + 1 : end;
+    }
+
+    std::vector<DenseGraph> graphs(starts.size());
+    std::atomic<bool> strict{true};
+    auto parse = [&](std::size_t i) {
+        if (!strict.load(std::memory_order_relaxed)) return;
+        const char* last = i + 1 < starts.size() ? starts[i + 1] : end;
+        if (!parseGraphStrict(starts[i], last, graphs[i]))
+            strict.store(false, std::memory_order_relaxed);
+    };
+
+    if (threads == 1 || starts.size() < 2) {
+        for (std::size_t i = 0; i < starts.size(); ++i) parse(i);
+    } else {
+        WorkStealingPool pool(threads);
+        for (std::size_t i = 0; i < starts.size(); ++i)
+            pool.submit([&parse, i]{ parse(i); });
+        pool.wait();
+    }
+
+    if (!strict.load()) return loadGraphs(fileName);
+    return graphs;
+}
+
 /*------------------------------------------------------------
  *  writeMatrix("start_matrix.txt", G.A);
  *-----------------------------------------------------------*/
@@ -136,4 +257,18 @@ inline void writeMatrix(const std::string& fileName,
             fout << std::setw(2) << M(i,j) << ' ';
         fout << '\n';
     }
-}
\ No newline at end of file
+}
+
+/*------------------------------------------------------------
+ *  writeGraphsBinary("graphs.ogb", loadGraphs("graphs.txt"));
+ *  двоичный контейнер (GraphBinary.h), d= сохраняется как density
+ *-----------------------------------------------------------*/
+inline void writeGraphsBinary(const std::string& fileName,
+                              const std::vector<DenseGraph>& graphs,
+                              bool dense = false)
+{
+    graphio::BinaryGraphWriter w(fileName);
+    for (const auto& g : graphs)
+        w.add(CsrGraph::fromDense(g.A), g.density, -1, dense);
+    w.close();
+}
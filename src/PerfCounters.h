@@ -0,0 +1,171 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+/*---------------------------------------------------------------*
+ |  Аппаратные счётчики вокруг вызова решателя (Linux,            |
+ |  perf_event_open)                                              |
+ |                                                                |
+ |    perf::Counters pc;          // открыть один раз             |
+ |    pc.start();  solve();  perf::Sample s = pc.stop();          |
+ |                                                                |
+ |  Считаются только события процесса в user space (как у         |
+ |  perf stat -e …:u), так что хватает perf_event_paranoid ≤ 2.    |
+ |  Потоки, созданные после start() (пулы решателей), попадают в  |
+ |  счёт через inherit, когда они завершаются, — пул должен быть  |
+ |  разрушен до stop().                                           |
+ |                                                                |
+ |  Каждый счётчик открывается отдельно: то, что ядро или         |
+ |  виртуальная машина не дают открыть, просто отсутствует в      |
+ |  Sample (has() == false). При мультиплексировании значения     |
+ |  масштабируются на долю времени, когда счётчик работал. Вне    |
+ |  Linux счётчиков нет, start/stop ничего не делают.             |
+ *---------------------------------------------------------------*/
+namespace perf
+{
+
+enum Event : int
+{
+    Cycles,
+    Instructions,
+    L1dMisses,          // промахи чтения L1D
+    LlcMisses,          // промахи последнего уровня кэша
+    BranchMisses,
+    kEventCount
+};
+
+inline const char* eventName(int e)
+{
+    static const char* const names[kEventCount] = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+    return names[e];
+}
+
+struct Sample
+{
+    std::array<std::uint64_t, kEventCount> value{};
+    std::array<bool, kEventCount>          ok{};
+    bool multiplexed = false;              // значения масштабированы
+
+    bool has(int e) const { return ok[e]; }
+    bool any() const
+    {
+        for (bool b : ok) if (b) return true;
+        return false;
+    }
+    double ipc() const
+    {
+        return has(Cycles) && has(Instructions) && value[Cycles]
+                   ? static_cast<double>(value[Instructions]) / value[Cycles] : 0.0;
+    }
+};
+
+#if defined(__linux__)
+
+class Counters
+{
+public:
+    Counters()
+    {
+        fd_.fill(-1);
+        fd_[Cycles]       = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fd_[Instructions] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fd_[L1dMisses]    = open(PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D));
+        fd_[LlcMisses]    = open(PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL));
+        if (fd_[LlcMisses] < 0)            // не у всех PMU есть LL-read-miss
+            fd_[LlcMisses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fd_[BranchMisses] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    }
+
+    ~Counters()
+    {
+        for (int fd : fd_) if (fd >= 0) ::close(fd);
+    }
+
+    Counters(const Counters&)            = delete;
+    Counters& operator=(const Counters&) = delete;
+
+    // открыт ли хоть один счётчик
+    bool available() const
+    {
+        for (int fd : fd_) if (fd >= 0) return true;
+        return false;
+    }
+
+    void start()
+    {
+        for (int fd : fd_) if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        for (int fd : fd_) if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    Sample stop()
+    {
+        for (int fd : fd_) if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        Sample s;
+        for (int e = 0; e < kEventCount; ++e) {
+            if (fd_[e] < 0) continue;
+            std::uint64_t buf[3];          // value, time_enabled, time_running
+            if (::read(fd_[e], buf, sizeof buf) != static_cast<ssize_t>(sizeof buf)) continue;
+            if (buf[2] == 0) {
+                if (buf[1] != 0) continue; // счётчику так и не досталось PMU
+                s.value[e] = 0;            // вызов короче разрешения часов
+            } else if (buf[2] < buf[1]) {
+                s.value[e] = static_cast<std::uint64_t>(
+                    static_cast<double>(buf[0]) * buf[1] / buf[2]);
+                s.multiplexed = true;
+            } else {
+                s.value[e] = buf[0];
+            }
+            s.ok[e] = true;
+        }
+        return s;
+    }
+
+private:
+    std::array<int, kEventCount> fd_;
+
+    static std::uint64_t cacheMiss(std::uint64_t cache)
+    {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    static int open(std::uint32_t type, std::uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof attr);
+        attr.size           = sizeof attr;
+        attr.type           = type;
+        attr.config         = config;
+        attr.disabled       = 1;
+        attr.inherit        = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        return fd < 0 ? -1 : static_cast<int>(fd);
+    }
+};
+
+#else
+
+class Counters
+{
+public:
+    bool   available() const { return false; }
+    void   start() {}
+    Sample stop() { return {}; }
+};
+
+#endif
+
+} // namespace perf
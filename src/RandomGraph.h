@@ -0,0 +1,135 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "CsrGraph.h"
+#include "WorkStealingPool.h"
+#include "method/Graph.h"
+
+/*---------------------------------------------------------------*
+ |  Случайный граф G(n, p) по зерну                               |
+ |                                                                |
+ |  Пары i < j перебираются по строкам, но не по одной: расстояние|
+ |  до следующего ребра — геометрическое, ⌊ln U / ln(1−p)⌋, так    |
+ |  что работа пропорциональна числу рёбер, а не n².              |
+ |                                                                |
+ |  Строки делятся на kChunks блоков примерно равного числа пар;  |
+ |  у блока k свой поток splitmix64(seed, k). Разбиение зависит   |
+ |  только от n, поэтому граф определяется парой (n, p, seed) и   |
+ |  не зависит от числа потоков.                                  |
+ *---------------------------------------------------------------*/
+namespace RandomGraph
+{
+
+constexpr std::size_t kChunks = 256;
+
+/* splitmix64: шаг генератора */
+inline std::uint64_t splitmix64(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/* независимый поток для блока k */
+inline std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t k)
+{
+    std::uint64_t s = seed;
+    const std::uint64_t a = splitmix64(s);
+    std::uint64_t t = a ^ (k * 0xD1B54A32D192ED03ull);
+    return splitmix64(t);
+}
+
+using Edge = std::pair<CsrGraph::Vertex, CsrGraph::Vertex>;
+
+/* рёбра G(n, p) в строках [rowBegin, rowEnd), по возрастанию (i, j) */
+inline void gnpRows(std::size_t n, double p, std::size_t rowBegin, std::size_t rowEnd,
+                    std::uint64_t state, std::vector<Edge>& out)
+{
+    if (p <= 0 || rowBegin >= rowEnd) return;
+    const double logq = p < 1 ? std::log1p(-p) : 0.0;
+
+    std::size_t i = rowBegin, j = rowBegin;     // j — последний просмотренный столбец
+    for (;;) {
+        std::size_t skip = 0;
+        if (p < 1) {
+            /* U ∈ (0, 1] */
+            const double u = (static_cast<double>(splitmix64(state) >> 11) + 1.0) * 0x1.0p-53;
+            const double s = std::floor(std::log(u) / logq);
+            skip = s < static_cast<double>(n) * n ? static_cast<std::size_t>(s) : n * n;
+        }
+        j += 1 + skip;
+        while (j >= n && i < rowEnd) {          // перенос в следующие строки
+            j = j - n + i + 2;
+            ++i;
+        }
+        if (i >= rowEnd) return;
+        out.emplace_back(static_cast<CsrGraph::Vertex>(i), static_cast<CsrGraph::Vertex>(j));
+    }
+}
+
+/* границы блоков строк: примерно поровну пар в каждом */
+inline std::vector<std::size_t> chunkRows(std::size_t n)
+{
+    const double total = 0.5 * static_cast<double>(n) * (n > 0 ? n - 1 : 0);
+    const double per   = std::max(1.0, total / kChunks);
+    std::vector<std::size_t> rows{0};
+    double acc = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        acc += static_cast<double>(n - 1 - i);
+        if (acc >= per * rows.size() && i + 1 < n) rows.push_back(i + 1);
+    }
+    rows.push_back(n);
+    return rows;
+}
+
+/* все рёбра G(n, p); блоки — на пуле из threads потоков (0 — по числу ядер) */
+inline std::vector<Edge> gnpEdges(std::size_t n, double p, std::uint64_t seed,
+                                  unsigned threads = 0)
+{
+    const auto rows = chunkRows(n);
+    const std::size_t chunks = rows.size() - 1;
+    std::vector<std::vector<Edge>> parts(chunks);
+    auto run = [&](std::size_t k) {
+        gnpRows(n, p, rows[k], rows[k + 1], streamSeed(seed, k), parts[k]);
+    };
+
+    if (threads == 1 || chunks < 2) {
+        for (std::size_t k = 0; k < chunks; ++k) run(k);
+    } else {
+        WorkStealingPool pool(threads);
+        for (std::size_t k = 0; k < chunks; ++k) pool.submit([&run, k]{ run(k); });
+        pool.wait();
+    }
+
+    std::size_t m = 0;
+    for (const auto& e : parts) m += e.size();
+    std::vector<Edge> edges;
+    edges.reserve(m);
+    for (auto& e : parts) {
+        edges.insert(edges.end(), e.begin(), e.end());
+        std::vector<Edge>().swap(e);
+    }
+    return edges;
+}
+
+/* разреженный G(n, p) */
+inline CsrGraph gnp(std::size_t n, double p, std::uint64_t seed, unsigned threads = 0)
+{
+    return CsrGraph::fromEdges(n, gnpEdges(n, p, seed, threads));
+}
+
+/* тот же граф плотной симметричной 0/1-матрицей */
+inline DenseMatrix gnpDense(int n, double p, std::uint64_t seed, unsigned threads = 1)
+{
+    DenseMatrix A = DenseMatrix::Zero(n, n);
+    for (const auto& [i, j] : gnpEdges(static_cast<std::size_t>(n), p, seed, threads))
+        A(i, j) = A(j, i) = 1;
+    return A;
+}
+
+} // namespace RandomGraph
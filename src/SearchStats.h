@@ -0,0 +1,131 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/*---------------------------------------------------------------*
+ |  SearchStats — сколько работы сделал точный поиск              |
+ |  (DSaturBnB, BacktrackingColoring, OlemskoyColorGraph)         |
+ |                                                                |
+ |  Счётчики обычные, не атомарные: у каждого обхода (задачи,     |
+ |  рабочего) свой экземпляр, в конце они складываются merge().   |
+ |  В горячем цикле — только инкременты; часы читаются лишь на    |
+ |  границах фаз и при новом рекорде. Построение G-пар идёт в     |
+ |  каждом узле, поэтому замеряется выборочно: каждый             |
+ |  kGPairSample-й вызов, итог масштабируется на число вызовов.   |
+ |                                                                |
+ |  В параллельном режиме searchSeconds — wall time перебора, а   |
+ |  gpairSeconds() — сумма по рабочим и может его превышать.      |
+ *---------------------------------------------------------------*/
+struct SearchStats
+{
+    using Clock = std::chrono::steady_clock;
+
+    /* причины отсечения */
+    enum Prune : int
+    {
+        Bound,          // нижняя граница ≥ рекорда (DSATUR, MIS)
+        CheckA,         // Олемский: проверки A, B, C
+        CheckB,
+        CheckC,
+        PsiZ,           // Олемский: Ψ\Z выкинуло вершины
+        kPruneCount
+    };
+
+    struct Improvement
+    {
+        int    value;                      // новое χ
+        double seconds;                    // от start
+    };
+
+    std::uint64_t                           nodes    = 0;   // раскрытые узлы
+    std::array<std::uint64_t, kPruneCount>  prunes{};
+    int                                     maxDepth = 0;
+    std::vector<Improvement>                improvements;
+
+    double setupSeconds  = 0;              // границы, нарезка префиксов
+    double searchSeconds = 0;              // перебор (включая G-пары)
+
+    /* построение G-пар (Олемский) */
+    static constexpr std::uint64_t kGPairSample = 64;
+    std::uint64_t gpairBuilds       = 0;
+    std::uint64_t gpairTimed        = 0;
+    double        gpairTimedSeconds = 0;
+
+    Clock::time_point start = Clock::now();
+
+    void node(int depth)
+    {
+        ++nodes;
+        if (depth > maxDepth) maxDepth = depth;
+    }
+    void prune(Prune p) { ++prunes[p]; }
+    void improved(int value) { improvements.push_back({value, seconds()}); }
+
+    // замерять ли очередное построение G-пар
+    bool sampleGPair() { return gpairBuilds++ % kGPairSample == 0; }
+    void gpairTimedBuild(double seconds)
+    {
+        ++gpairTimed;
+        gpairTimedSeconds += seconds;
+    }
+    double gpairSeconds() const
+    {
+        return gpairTimed ? gpairTimedSeconds * static_cast<double>(gpairBuilds) / gpairTimed : 0.0;
+    }
+
+    double seconds() const  { return since(start); }
+    static double since(Clock::time_point t0)
+    {
+        return std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    std::uint64_t totalPrunes() const
+    {
+        std::uint64_t s = 0;
+        for (auto p : prunes) s += p;
+        return s;
+    }
+
+    // прибавить статистику другой задачи (start у всех общий);
+    // setupSeconds и searchSeconds остаются за вызывающим
+    void merge(const SearchStats& o)
+    {
+        nodes += o.nodes;
+        for (int p = 0; p < kPruneCount; ++p) prunes[p] += o.prunes[p];
+        maxDepth = std::max(maxDepth, o.maxDepth);
+        gpairBuilds       += o.gpairBuilds;
+        gpairTimed        += o.gpairTimed;
+        gpairTimedSeconds += o.gpairTimedSeconds;
+
+        /* по времени; остаются только строгие улучшения χ — при равном χ
+           параллельный рекорд ещё меняется ради детерминизма (ParallelBnB.h) */
+        improvements.insert(improvements.end(), o.improvements.begin(), o.improvements.end());
+        std::stable_sort(improvements.begin(), improvements.end(),
+                         [](const Improvement& a, const Improvement& b) { return a.seconds < b.seconds; });
+        std::size_t kept = 0;
+        for (const auto& i : improvements)
+            if (kept == 0 || i.value < improvements[kept - 1].value) improvements[kept++] = i;
+        improvements.resize(kept);
+    }
+
+    static const char* pruneName(int p)
+    {
+        static const char* const names[kPruneCount] = {"bound", "checkA", "checkB", "checkC", "psiZ"};
+        return names[p];
+    }
+
+    void print(std::ostream& out) const
+    {
+        out << "nodes: " << nodes << "  max depth: " << maxDepth << "\nprunes:";
+        for (int p = 0; p < kPruneCount; ++p)
+            if (prunes[p]) out << ' ' << pruneName(p) << '=' << prunes[p];
+        out << "\nimprovements:";
+        for (const auto& i : improvements) out << ' ' << i.value << '@' << i.seconds << 's';
+        out << "\ntime: setup " << setupSeconds << "s, gpair ~" << gpairSeconds()
+            << "s (" << gpairBuilds << " builds), search " << searchSeconds << "s\n";
+    }
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*---------------------------------------------------------------*
+ |  WorkStealingPool                                              |
+ |                                                                |
+ |  У каждого рабочего своя дека задач: свои задачи он берёт с    |
+ |  хвоста (LIFO, горячий кэш), у соседей крадёт с головы (FIFO,  |
+ |  самые крупные поддеревья). Задачи могут порождать задачи.     |
+ |                                                                |
+ |  wait() вызывается только вне пула: ждёт, пока не завершатся   |
+ |  все задачи (включая порождённые), и пробрасывает первое       |
+ |  исключение, вылетевшее из задачи.                             |
+ *---------------------------------------------------------------*/
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(unsigned threads = 0)
+    {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 0; i < threads; ++i)
+            queues_.push_back(std::make_unique<Queue>());
+        for (unsigned i = 0; i < threads; ++i)
+            workers_.emplace_back([this, i]{ workerLoop(i); });
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk(sleepM_);
+            stop_ = true;
+        }
+        sleepCv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&)            = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues_.size()); }
+
+    // из рабочего этого пула — в свою деку, иначе — по кругу
+    void submit(Task task)
+    {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        int self = workerIndex();
+        unsigned target = self >= 0
+            ? static_cast<unsigned>(self)
+            : rr_.fetch_add(1, std::memory_order_relaxed) % size();
+        {
+            std::lock_guard<std::mutex> lk(queues_[target]->m);
+            queues_[target]->q.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lk(sleepM_);
+            ++queued_;
+        }
+        sleepCv_.notify_one();
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lk(sleepM_);
+        doneCv_.wait(lk, [&]{ return pending_.load() == 0; });
+        if (error_) {
+            auto e = error_;
+            error_ = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    // есть простаивающие рабочие → имеет смысл отдавать работу
+    bool hungry() const { return idle_.load(std::memory_order_relaxed) > 0; }
+
+    // индекс текущего рабочего этого пула или -1
+    int workerIndex() const { return tlsPool_ == this ? tlsIndex_ : -1; }
+
+private:
+    struct Queue {
+        std::mutex       m;
+        std::deque<Task> q;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread>            workers_;
+
+    std::mutex              sleepM_;             // защищает queued_, stop_, error_
+    std::condition_variable sleepCv_, doneCv_;
+    std::size_t             queued_ = 0;         // задач в деках
+    bool                    stop_   = false;
+    std::exception_ptr      error_;
+
+    std::atomic<std::size_t> pending_{0};        // отправлено, но не завершено
+    std::atomic<int>         idle_{0};
+    std::atomic<unsigned>    rr_{0};
+
+    inline static thread_local const WorkStealingPool* tlsPool_  = nullptr;
+    inline static thread_local int                     tlsIndex_ = -1;
+
+    bool tryPop(unsigned self, Task& task)
+    {
+        {   /* своя дека — с хвоста */
+            std::lock_guard<std::mutex> lk(queues_[self]->m);
+            auto& q = queues_[self]->q;
+            if (!q.empty()) {
+                task = std::move(q.back());
+                q.pop_back();
+                return true;
+            }
+        }
+        /* кража — с головы чужой деки */
+        for (unsigned k = 1; k < size(); ++k) {
+            auto& victim = *queues_[(self + k) % size()];
+            std::lock_guard<std::mutex> lk(victim.m);
+            if (!victim.q.empty()) {
+                task = std::move(victim.q.front());
+                victim.q.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(unsigned self)
+    {
+        tlsPool_  = this;
+        tlsIndex_ = static_cast<int>(self);
+
+        for (;;) {
+            Task task;
+            if (tryPop(self, task)) {
+                {
+                    std::lock_guard<std::mutex> lk(sleepM_);
+                    --queued_;
+                }
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lk(sleepM_);
+                    if (!error_) error_ = std::current_exception();
+                }
+                if (pending_.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lk(sleepM_);
+                    doneCv_.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lk(sleepM_);
+            if (stop_ && queued_ == 0) return;
+            idle_.fetch_add(1, std::memory_order_relaxed);
+            sleepCv_.wait(lk, [&]{ return stop_ || queued_ > 0; });
+            idle_.fetch_sub(1, std::memory_order_relaxed);
+            if (stop_ && queued_ == 0) return;
+        }
+    }
+};
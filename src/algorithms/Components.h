@@ -0,0 +1,258 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "../CsrGraph.h"
+#include "../WorkStealingPool.h"
+#include "DSaturColoring.h"
+
+/*---------------------------------------------------------------*
+ |  Разбиение на компоненты перед раскраской                      |
+ |                                                                |
+ |  χ(G) — максимум χ по компонентам связности, и то же верно для |
+ |  блоков (компонент двусвязности): блоки сходятся в точках      |
+ |  сочленения, а раскраску блока всегда можно переставить так,   |
+ |  чтобы цвет точки сочленения совпал с уже назначенным.         |
+ |                                                                |
+ |  Части решаются задачами WorkStealingPool, крупные первыми     |
+ |  (solve зовётся из нескольких потоков сразу); номера вершин в  |
+ |  части — локальные, по возрастанию исходных.                   |
+ |  Общий floor — наибольшее число цветов среди решённых частей:  |
+ |  часть, которую DSatur красит не больше чем в floor цветов,    |
+ |  точный решатель уже не улучшит ответ, и её решение            |
+ |  пропускается.                                                 |
+ |                                                                |
+ |  Сборка: компоненты не пересекаются, блоки обходятся по дереву |
+ |  блоков и точек сочленения (BFS) — у очередного блока окрашена |
+ |  ровно одна вершина, и его цвета переставляются под неё.       |
+ *---------------------------------------------------------------*/
+namespace components
+{
+
+using Edge = std::pair<CsrGraph::Vertex, CsrGraph::Vertex>;
+
+struct Part
+{
+    std::vector<int>  vertices;         // исходные номера, по возрастанию
+    std::vector<Edge> edges;            // исходные номера
+};
+
+/*-------- компоненты связности (BFS) --------------------------*/
+inline std::vector<Part> connected(const CsrGraph& g)
+{
+    const int n = static_cast<int>(g.size());
+    std::vector<int> comp(n, -1);
+    std::vector<Part> parts;
+    std::vector<int> queue;
+    for (int r = 0; r < n; ++r) {
+        if (comp[r] >= 0) continue;
+        const int id = static_cast<int>(parts.size());
+        parts.emplace_back();
+        queue.assign(1, r);
+        comp[r] = id;
+        for (std::size_t h = 0; h < queue.size(); ++h)
+            for (auto u : g.neighbours(queue[h]))
+                if (comp[u] < 0) {
+                    comp[u] = id;
+                    queue.push_back(static_cast<int>(u));
+                }
+        std::sort(queue.begin(), queue.end());
+        parts.back().vertices = queue;
+    }
+    for (int v = 0; v < n; ++v)
+        for (auto u : g.neighbours(v))
+            if (static_cast<int>(u) > v)
+                parts[comp[v]].edges.emplace_back(static_cast<CsrGraph::Vertex>(v), u);
+    return parts;
+}
+
+/*-------- блоки (Тарьян, без рекурсии, стек рёбер) ------------*/
+inline std::vector<Part> biconnected(const CsrGraph& g)
+{
+    const int n = static_cast<int>(g.size());
+    std::vector<int> disc(n, -1), low(n, 0), stamp(n, -1);
+    std::vector<Part> parts;
+    std::vector<Edge> estack;
+
+    struct Frame { int v, parent; CsrGraph::Offset next; };
+    std::vector<Frame> stack;
+    const CsrGraph::Offset* off = g.offsetData();
+    const CsrGraph::Vertex* adj = g.neighbourData();
+    int time = 0;
+
+    for (int r = 0; r < n; ++r) {
+        if (disc[r] >= 0) continue;
+        disc[r] = low[r] = time++;
+        if (g.degree(r) == 0) {                        // изолированная — свой блок
+            parts.push_back({{r}, {}});
+            continue;
+        }
+        stack.push_back({r, -1, off[r]});
+        while (!stack.empty()) {
+            Frame& f = stack.back();
+            const int v = f.v;
+            if (f.next < off[v + 1]) {
+                const int w = static_cast<int>(adj[f.next++]);
+                if (disc[w] < 0) {
+                    estack.emplace_back(v, w);
+                    disc[w] = low[w] = time++;
+                    stack.push_back({w, v, off[w]});
+                } else if (w != f.parent && disc[w] < disc[v]) {
+                    estack.emplace_back(v, w);         // обратное ребро
+                    low[v] = std::min(low[v], disc[w]);
+                }
+                continue;
+            }
+            stack.pop_back();
+            if (stack.empty()) break;
+            const int p = stack.back().v;
+            low[p] = std::min(low[p], low[v]);
+            if (low[v] < disc[p]) continue;
+
+            /* p отделяет поддерево v: рёбра до (p, v) — блок */
+            Part part;
+            const int id = static_cast<int>(parts.size());
+            for (;;) {
+                const Edge e = estack.back();
+                estack.pop_back();
+                part.edges.push_back(e);
+                for (int x : {static_cast<int>(e.first), static_cast<int>(e.second)})
+                    if (stamp[x] != id) { stamp[x] = id; part.vertices.push_back(x); }
+                if (static_cast<int>(e.first) == p && static_cast<int>(e.second) == v) break;
+            }
+            std::sort(part.vertices.begin(), part.vertices.end());
+            parts.push_back(std::move(part));
+        }
+    }
+    return parts;
+}
+
+/* часть с локальными номерами: local[v] — номер v в части (-1 вне её) */
+inline CsrGraph subgraph(const Part& part, std::vector<int>& local)
+{
+    for (std::size_t k = 0; k < part.vertices.size(); ++k)
+        local[part.vertices[k]] = static_cast<int>(k);
+    std::vector<Edge> edges;
+    edges.reserve(part.edges.size());
+    for (const auto& [u, v] : part.edges)
+        edges.emplace_back(static_cast<CsrGraph::Vertex>(local[u]),
+                           static_cast<CsrGraph::Vertex>(local[v]));
+    for (int v : part.vertices) local[v] = -1;
+    return CsrGraph::fromEdges(part.vertices.size(), edges);
+}
+
+struct Options
+{
+    bool     blocks  = false;           // блоки вместо компонент связности
+    unsigned threads = 0;               // 0 — по числу ядер
+};
+
+struct Split
+{
+    std::size_t parts   = 0;
+    std::size_t largest = 0;            // вершин в наибольшей части
+    std::size_t solved  = 0;            // решено решателем
+    std::size_t skipped = 0;            // хватило DSatur (≤ floor цветов)
+};
+
+/*---------------------------------------------------------------*
+ |  colour: части → solve(часть) → раскраска графа (0-based)      |
+ *---------------------------------------------------------------*/
+template<class Solve>
+std::vector<int> colour(const CsrGraph& g, Solve&& solve, const Options& opt = {},
+                        Split* info = nullptr)
+{
+    const int n = static_cast<int>(g.size());
+    std::vector<Part> parts = opt.blocks ? biconnected(g) : connected(g);
+
+    std::vector<CsrGraph> graphs;
+    graphs.reserve(parts.size());
+    std::vector<int> local(n, -1);
+    for (const auto& p : parts) graphs.push_back(subgraph(p, local));
+
+    /* крупные первыми: они задают floor для остальных */
+    std::vector<std::size_t> order(parts.size());
+    for (std::size_t k = 0; k < order.size(); ++k) order[k] = k;
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return graphs[a].edges() > graphs[b].edges();
+    });
+
+    std::vector<std::vector<int>> cols(parts.size());
+    std::vector<char>             solved(parts.size(), 0);
+    std::atomic<int>              floor{0};
+    auto work = [&](std::size_t k) {
+        const CsrGraph& h = graphs[k];
+        std::vector<int> col = DSaturColoring::color(h);
+        const int ub = col.empty() ? 0 : *std::max_element(col.begin(), col.end()) + 1;
+        if (ub > floor.load(std::memory_order_relaxed)) {
+            col       = solve(h);
+            solved[k] = 1;
+        }
+        const int used = col.empty() ? 0 : *std::max_element(col.begin(), col.end()) + 1;
+        int cur = floor.load(std::memory_order_relaxed);
+        while (used > cur && !floor.compare_exchange_weak(cur, used, std::memory_order_relaxed)) {}
+        cols[k] = std::move(col);
+    };
+
+    if (opt.threads == 1 || parts.size() < 2) {
+        for (std::size_t k : order) work(k);
+    } else {
+        WorkStealingPool pool(opt.threads);
+        for (std::size_t i = order.size(); i-- > 0; )   // LIFO: order[0] первым
+            pool.submit([&work, k = order[i]]{ work(k); });
+        pool.wait();
+    }
+
+    /* сборка */
+    std::vector<int> colour(n, -1);
+    if (!opt.blocks) {
+        for (std::size_t k = 0; k < parts.size(); ++k)
+            for (std::size_t i = 0; i < parts[k].vertices.size(); ++i)
+                colour[parts[k].vertices[i]] = cols[k][i];
+    } else {
+        std::vector<std::vector<int>> blocksOf(n);
+        for (std::size_t k = 0; k < parts.size(); ++k)
+            for (int v : parts[k].vertices) blocksOf[v].push_back(static_cast<int>(k));
+
+        std::vector<char> done(parts.size(), 0);
+        std::vector<int>  queue;
+        for (std::size_t root = 0; root < parts.size(); ++root) {
+            if (done[root]) continue;
+            done[root] = 1;
+            queue.assign(1, static_cast<int>(root));
+            for (std::size_t h = 0; h < queue.size(); ++h) {
+                const Part&             p  = parts[queue[h]];
+                const std::vector<int>& lc = cols[queue[h]];
+
+                /* окрашенная вершина (точка сочленения с родителем): y → x, x → y */
+                int x = -1, y = -1;
+                for (std::size_t i = 0; i < p.vertices.size(); ++i)
+                    if (colour[p.vertices[i]] >= 0) { x = colour[p.vertices[i]]; y = lc[i]; break; }
+                for (std::size_t i = 0; i < p.vertices.size(); ++i) {
+                    const int v = p.vertices[i];
+                    if (colour[v] >= 0) continue;
+                    const int c = lc[i];
+                    colour[v] = c == y ? x : c == x ? y : c;
+                }
+                for (int v : p.vertices)
+                    for (int b : blocksOf[v])
+                        if (!done[b]) { done[b] = 1; queue.push_back(b); }
+            }
+        }
+    }
+
+    if (info) {
+        *info = Split{};
+        info->parts = parts.size();
+        for (std::size_t k = 0; k < parts.size(); ++k) {
+            info->largest = std::max(info->largest, parts[k].vertices.size());
+            if (solved[k]) ++info->solved; else ++info->skipped;
+        }
+    }
+    return colour;
+}
+
+} // namespace components
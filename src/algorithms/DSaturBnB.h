@@ -6,7 +6,11 @@
 #include <algorithm>
 #include <numeric>
 #include <cstdint>
-#include <functional>
+
+#include "../CsrGraph.h"
+#include "../SearchStats.h"
+#include "MaxClique.h"
+#include "ParallelBnB.h"
 
 namespace DSaturBnB
 {
@@ -19,26 +23,26 @@ using DenseMatrix =
 /*--------------------------------------------------------------*/
 /*  Быстрый жадный Welsh–Powell  ⇒  начальная верхняя граница   */
 /*--------------------------------------------------------------*/
-inline int greedyUB(const DenseMatrix& A, std::vector<int>& col)
+inline int greedyUB(const CsrGraph& g, std::vector<int>& col)
 {
-    const int n = A.rows();
+    const int n = static_cast<int>(g.size());
     col.assign(n, -1);
 
     /* — упорядочиваем вершины по убыванию степеней — */
     std::vector<int> order(n);
     std::iota(order.begin(), order.end(), 0);
     std::sort(order.begin(), order.end(), [&](int a, int b)
-              { return A.row(a).sum() > A.row(b).sum(); });
+              { return g.degree(a) > g.degree(b); });
 
     int used = 0;
-    std::vector<int> forbid(n, 0), stamp(n, 0);
+    std::vector<int> stamp(n, 0);
     int curStamp = 1;
 
     for (int v : order)
     {
         /* отмечаем занятые цвета */
-        for (int u = 0; u < n; ++u)
-            if (A(v, u) && col[u] != -1)
+        for (auto u : g.neighbours(v))
+            if (col[u] != -1)
                 stamp[col[u]] = curStamp;
 
         int c = 0;
@@ -50,103 +54,369 @@ inline int greedyUB(const DenseMatrix& A, std::vector<int>& col)
     return used;                       /* χᴳ */
 }
 
+inline int greedyUB(const DenseMatrix& A, std::vector<int>& col)
+{
+    return greedyUB(CsrGraph::fromDense(A), col);
+}
+
+/*--------------------------------------------------------------*/
+/*  Неизменные данные задачи: смежность одним массивом (CSR),   */
+/*  степени, жадная оценка χᴳ и клика K (нижняя граница).        */
+/*--------------------------------------------------------------*/
+struct Problem
+{
+    int n = 0;
+    std::vector<int> adjStart, adj, degree;
+    std::vector<int> greedy;               // раскраска χᴳ
+    int UB = 0;                            // χᴳ
+    int width = 0;                         // цвета в пути всегда < χᴳ
+    std::vector<int> clique;
+    int LB = 0;                            // |K|
+
+    explicit Problem(const CsrGraph& g) : n(static_cast<int>(g.size()))
+    {
+        adjStart.assign(n + 1, 0);
+        adj.reserve(g.edges() * 2);
+        for (int i = 0; i < n; ++i)
+        {
+            for (auto j : g.neighbours(i)) adj.push_back(static_cast<int>(j));
+            adjStart[i + 1] = static_cast<int>(adj.size());
+        }
+        degree.resize(n);
+        for (int i = 0; i < n; ++i) degree[i] = adjStart[i + 1] - adjStart[i];
+
+        UB     = greedyUB(g, greedy);
+        width  = UB;
+        clique = MaxClique::find(g, UB);
+        LB     = static_cast<int>(clique.size());
+    }
+
+    explicit Problem(const DenseMatrix& A) : Problem(CsrGraph::fromDense(A)) {}
+};
+
 /*--------------------------------------------------------------*/
-/*  Основная функция: точная DSATUR + B&B                       */
+/*  Search: точная DSATUR + B&B из заданного корня              */
+/*                                                              */
+/*  Поиск — без рекурсии: явный стек кадров (вершина, текущий   */
+/*  цвет, следующий кандидат) и журнал отмен. Все буферы        */
+/*  выделяются один раз до поиска; горячий цикл не вызывает     */
+/*  std::function и не выделяет память.                         */
+/*                                                              */
+/*  Вершины клики K сразу получают цвета 0…|K|-1, а поиск        */
+/*  заканчивается, как только рекорд опустился до |K|.          */
+/*                                                              */
+/*  Incumbent — рекорд: bound() (отсекаем χ ≥ bound()) и        */
+/*  offer(χ, раскраска), см. ParallelBnB.h. Узлы, отсечения и   */
+/*  новые рекорды считаются в stats.                             */
 /*--------------------------------------------------------------*/
-inline std::vector<int> color(const DenseMatrix& A)
+template<class Incumbent>
+class Search
 {
-    const int n = A.rows();
-
-    /* ---------- списки смежности + степени ---------- */
-    std::vector<std::vector<int>> adj(n);
-    std::vector<int> degree(n, 0);
-    for (int i = 0; i < n; ++i)
-        for (int j = 0; j < n; ++j)
-            if (A(i, j))
+public:
+    Search(const Problem& P, Incumbent& inc, SearchStats& stats)
+        : P_(P), inc_(inc), stats_(stats), n_(P.n), width_(P.width),
+          colour_(P.n, -1), sat_(P.n, 0),
+          forbid_(static_cast<std::size_t>(P.n) * P.width, 0),
+          trail_(P.adj.size()), stack_(P.n + 1)
+    {
+        /* корень: вершины клики в разные цвета */
+        for (int k = 0; k < P_.LB; ++k) fix(P_.clique[k], k);
+    }
+
+    // закрепить назначения префикса (он уже допустим)
+    void replay(const pbnb::Prefix& prefix)
+    {
+        for (const auto& [v, c] : prefix) fix(v, c);
+    }
+
+    // обход поддерева корня; при out != nullptr узлы глубины
+    // stopDepth (и листья выше неё) не раскрываются, а
+    // записываются в out префиксами — в порядке DFS
+    void run(int stopDepth = -1, std::vector<pbnb::Prefix>* out = nullptr)
+    {
+        stopDepth_ = stopDepth;
+        out_       = out;
+        root_      = depth_;
+
+        if (!enter()) return;
+        for (;;)
+        {
+            Frame& f = stack_[depth_];
+            if (f.c != -1) unassign(f);
+
+            /* ---- следующий из уже используемых цветов ---- */
+            int c = f.next;
+            while (c < maxUsed_ && forbidCnt(f.v, c)) ++c;
+
+            bool descend = false;
+            if (c < maxUsed_)
             {
-                adj[i].push_back(j);
-                ++degree[i];
+                f.next = c + 1;
+                assign(f, c);
+                descend = true;
+            }
+            /* ---- пытаемся завести НОВЫЙ цвет ---- */
+            else if (!f.opened && maxUsed_ + 1 < inc_.bound())
+            {
+                f.opened = true;
+                f.next   = maxUsed_ + 1;
+                assign(f, maxUsed_);
+                ++maxUsed_;
+                descend = true;
             }
 
-    /* ---------- начальная greedy-граница χᴳ ---------- */
-    std::vector<int> best;                 // сюда greedyUB запишет раскраску
-    int UB = greedyUB(A, best);            // UB = χᴳ
+            if (descend)
+            {
+                ++depth_;
+                if (enter()) continue;
+                --depth_;
+                if (inc_.bound() <= P_.LB) break;   // оптимум доказан кликой
+                continue;                           // следующий цвет этого же кадра
+            }
+
+            /* кадр исчерпан */
+            if (depth_ == root_) break;
+            --depth_;
+        }
+    }
+
+private:
+    struct Frame
+    {
+        int v;                             // выбранная вершина
+        int c;                             // её текущий цвет или -1
+        int next;                          // следующий кандидат-цвет
+        int mark;                          // trailTop до назначения
+        bool opened;                       // новый цвет уже пробовали
+    };
 
-    /* ---------- рабочие структуры DFS  --------------- */
-    std::vector<int> colour(n, -1);        // текущая раскраска
-    std::vector<int> sat   (n,  0);        // насыщенность (|разн. цветов|)
-    std::vector<std::vector<uint8_t>>      // forbidCnt[v][c] : счётчик
-        forbidCnt(n, std::vector<uint8_t>(UB, 0));
+    const Problem& P_;
+    Incumbent&     inc_;
+    SearchStats&   stats_;
+    const int      n_, width_;
 
-    int maxUsed = 0;                       // max(colour)+1 в текущем пути
+    std::vector<int>           colour_;    // текущая раскраска
+    std::vector<int>           sat_;       // насыщенность (|разн. цветов|)
+    std::vector<std::uint32_t> forbid_;    // forbid[v*width + c] : счётчик
 
-    /* ---------- рекурсивный поиск  ------------------- */
-    std::function<void(int)> dfs = [&](int colored)
+    /* журнал отмен: незакрашенные соседи, у которых вырос счётчик;
+       каждая вершина пути кладёт не больше degree[v] записей       */
+    std::vector<int> trail_;
+    int              trailTop_ = 0;
+
+    std::vector<Frame> stack_;
+    int depth_   = 0;                      // = числу закрашенных
+    int root_    = 0;
+    int maxUsed_ = 0;                      // max(colour)+1 в текущем пути
+
+    int                        stopDepth_ = -1;
+    std::vector<pbnb::Prefix>* out_       = nullptr;
+
+    std::uint32_t& forbidCnt(int v, int c)
+    {
+        return forbid_[static_cast<std::size_t>(v) * width_ + c];
+    }
+
+    /* назначение без отмены (клика, префикс задачи) */
+    void fix(int v, int c)
     {
-        /* нижняя граница χ  (Brooks-like) */
-        int low = maxUsed;
-        for (int v = 0; v < n; ++v)
-            if (colour[v] == -1)
-                low = std::max(low, sat[v] + 1);
-        if (low >= UB) return;             // отсечение
+        colour_[v] = c;
+        for (int k = P_.adjStart[v]; k < P_.adjStart[v + 1]; ++k)
+        {
+            const int u = P_.adj[k];
+            if (colour_[u] == -1 && forbidCnt(u, c)++ == 0) ++sat_[u];
+        }
+        maxUsed_ = std::max(maxUsed_, c + 1);
+        ++depth_;
+    }
 
-        if (colored == n)                  // нашли полную раскраску
+    void assign(Frame& f, int c)
+    {
+        f.c         = c;
+        f.mark      = trailTop_;
+        colour_[f.v] = c;
+        for (int k = P_.adjStart[f.v]; k < P_.adjStart[f.v + 1]; ++k)
         {
-            UB   = maxUsed;
-            best = colour;
-            return;
+            const int u = P_.adj[k];
+            if (colour_[u] != -1) continue;
+            if (forbidCnt(u, c)++ == 0) ++sat_[u];
+            trail_[trailTop_++] = u;
         }
+    }
 
-        /* ---- выбираем вершину по DSATUR ---- */
+    void unassign(Frame& f)
+    {
+        const int c = f.c;
+        while (trailTop_ > f.mark)
+        {
+            const int u = trail_[--trailTop_];
+            if (--forbidCnt(u, c) == 0) --sat_[u];
+        }
+        colour_[f.v] = -1;
+        if (f.opened && c == maxUsed_ - 1) --maxUsed_;   // снимаем новый цвет
+        f.c = -1;
+    }
+
+    /* текущий путь (после корня) префиксом */
+    void emitPrefix()
+    {
+        pbnb::Prefix prefix;
+        for (int d = root_; d < depth_; ++d)
+            prefix.emplace_back(stack_[d].v, stack_[d].c);
+        out_->push_back(std::move(prefix));
+    }
+
+    /* вход в узел: отсечение, лист или выбор вершины; false → узел закрыт */
+    bool enter()
+    {
+        stats_.node(depth_);
+
+        /* нижняя граница χ (Brooks-like) и выбор вершины — за один проход */
+        int low = maxUsed_;
         int v = -1, bestSat = -1, bestDeg = -1;
-        for (int i = 0; i < n; ++i)
-            if (colour[i] == -1 &&
-               (sat[i] > bestSat || (sat[i] == bestSat && degree[i] > bestDeg)))
+        for (int i = 0; i < n_; ++i)
+            if (colour_[i] == -1)
             {
-                v       = i;
-                bestSat = sat[i];
-                bestDeg = degree[i];
+                low = std::max(low, sat_[i] + 1);
+                if (sat_[i] > bestSat || (sat_[i] == bestSat && P_.degree[i] > bestDeg))
+                {
+                    v       = i;
+                    bestSat = sat_[i];
+                    bestDeg = P_.degree[i];
+                }
             }
+        if (low >= inc_.bound())                     // отсечение
+        {
+            stats_.prune(SearchStats::Bound);
+            return false;
+        }
 
-        /* ---- перебираем уже используемые цвета ---- */
-        for (int c = 0; c < maxUsed; ++c)
+        if (out_ && (depth_ == stopDepth_ || depth_ == n_))
         {
-            if (forbidCnt[v][c]) continue;         // цвет запрещён
+            emitPrefix();
+            return false;
+        }
 
-            /* assign colour c */
-            colour[v] = c;
-            for (int u : adj[v])
-                if (colour[u] == -1 && forbidCnt[u][c]++ == 0) ++sat[u];
+        if (depth_ == n_)                  // нашли полную раскраску
+        {
+            if (inc_.offer(maxUsed_, colour_)) stats_.improved(maxUsed_);
+            return false;
+        }
 
-            dfs(colored + 1);
+        stack_[depth_] = Frame{v, -1, 0, trailTop_, false};
+        return true;
+    }
+};
 
-            /* undo */
-            for (int u : adj[v])
-                if (colour[u] == -1 && --forbidCnt[u][c] == 0) --sat[u];
-            colour[v] = -1;
-        }
+/*--------------------------------------------------------------*/
+/*  Основная функция: точная DSATUR + B&B.                       */
+/*  stats (если задан) — работа поиска; первый рекорд в нём —   */
+/*  жадная оценка χᴳ.                                            */
+/*--------------------------------------------------------------*/
+inline std::vector<int> color(const CsrGraph& g, SearchStats* stats = nullptr)
+{
+    SearchStats st;
+    const Problem P(g);
+    st.setupSeconds = st.seconds();
+    st.improved(P.UB);
+
+    pbnb::SerialIncumbent inc(P.UB, P.greedy);
+    if (P.LB < P.UB)                       // иначе χᴳ уже оптимально
+    {
+        const auto t0 = SearchStats::Clock::now();
+        Search<pbnb::SerialIncumbent>(P, inc, st).run();
+        st.searchSeconds = SearchStats::since(t0);
+    }
+    if (stats) *stats = std::move(st);
+    return inc.best();                     // 0-based цвета
+}
+
+/*--------------------------------------------------------------*/
+/*  То же на пуле из threads потоков (0 — по числу ядер).        */
+/*  Дерево режется на глубине, где набирается ≥ kTargetTasks     */
+/*  узлов; результат одинаков в каждом запуске. Статистика       */
+/*  задач складывается в порядке их номеров.                     */
+/*--------------------------------------------------------------*/
+inline std::vector<int> colorParallel(const CsrGraph& g, unsigned threads = 0,
+                                      SearchStats* stats = nullptr)
+{
+    SearchStats st;
+    const Problem P(g);
+    st.improved(P.UB);
+    if (P.LB >= P.UB)
+    {
+        st.setupSeconds = st.seconds();
+        if (stats) *stats = std::move(st);
+        return P.greedy;
+    }
+
+    /* префиксы: углубляемся, пока узлов мало и дерево не исчерпано */
+    std::vector<pbnb::Prefix> prefixes;
+    for (int extra = 1; P.LB + extra <= P.n; ++extra)
+    {
+        pbnb::SerialIncumbent probe(P.UB, P.greedy);
+        prefixes.clear();
+        Search<pbnb::SerialIncumbent>(P, probe, st).run(P.LB + extra, &prefixes);
 
-        /* ---- пытаемся завести НОВЫЙ цвет ---- */
-        if (maxUsed + 1 < UB)
+        bool deeper = false;               // есть ли узлы, которые можно раскрыть
+        for (const auto& pr : prefixes)
+            if (P.LB + (int)pr.size() < P.n) { deeper = true; break; }
+        if (prefixes.size() >= pbnb::kTargetTasks || !deeper) break;
+    }
+    st.setupSeconds = st.seconds();
+
+    std::vector<SearchStats> taskStats(prefixes.size());
+    for (auto& ts : taskStats) ts.start = st.start;
+
+    const auto t0 = SearchStats::Clock::now();
+    pbnb::SharedIncumbent inc(P.UB, P.greedy);
+    pbnb::runTasks(prefixes, inc, threads,
+        [&](std::size_t t, const pbnb::Prefix& prefix, pbnb::SharedIncumbent::View& view)
         {
-            int c = maxUsed;
-            colour[v] = c;
-            for (int u : adj[v])
-                if (colour[u] == -1 && forbidCnt[u][c]++ == 0) ++sat[u];
-
-            ++maxUsed;
-            dfs(colored + 1);
-            --maxUsed;
-
-            for (int u : adj[v])
-                if (colour[u] == -1 && --forbidCnt[u][c] == 0) --sat[u];
-            colour[v] = -1;
-        }
-    };
+            Search<pbnb::SharedIncumbent::View> search(P, view, taskStats[t]);
+            search.replay(prefix);
+            search.run();
+        });
+    for (const auto& ts : taskStats) st.merge(ts);
+    st.searchSeconds = SearchStats::since(t0);
+    if (stats) *stats = std::move(st);
+    return inc.best();
+}
 
-    dfs(/*colored=*/0);
-    return best;                           // 0-based цвета
+/*--------------------------------------------------------------*/
+/*  Поиск с внешним рекордом (Portfolio.h): своя жадная оценка   */
+/*  предлагается inc, дальше ищутся только раскраски лучше       */
+/*  inc.bound(). Если поиск не свернули извне (bound() упал до   */
+/*  |K| или ниже), по возвращении рекорд inc оптимален.          */
+/*--------------------------------------------------------------*/
+template<class Incumbent>
+void colorWith(const CsrGraph& g, Incumbent& inc, SearchStats* stats = nullptr)
+{
+    SearchStats st;
+    const Problem P(g);
+    st.setupSeconds = st.seconds();
+    if (inc.offer(P.UB, P.greedy)) st.improved(P.UB);
+
+    if (P.LB < inc.bound())
+    {
+        const auto t0 = SearchStats::Clock::now();
+        Search<Incumbent>(P, inc, st).run();
+        st.searchSeconds = SearchStats::since(t0);
+    }
+    if (stats) *stats = std::move(st);
+}
+
+/* плотная матрица: приводим к CSR один раз */
+inline std::vector<int> color(const DenseMatrix& A, SearchStats* stats = nullptr)
+{
+    return color(CsrGraph::fromDense(A), stats);
+}
+
+inline std::vector<int> colorParallel(const DenseMatrix& A, unsigned threads = 0,
+                                      SearchStats* stats = nullptr)
+{
+    return colorParallel(CsrGraph::fromDense(A), threads, stats);
 }
 
 } // namespace DSaturBnB
-#endif /* DSATUR_BNB_H */
\ No newline at end of file
+#endif /* DSATUR_BNB_H */
@@ -2,64 +2,106 @@
 #include <vector>
 #include <algorithm>
 #include <numeric>
+#include <cstdint>
+#include <unordered_set>
+
+#include "../CsrGraph.h"
 
 class DSaturColoring
 {
 private:                          
+    /*-----------------------------------------------------------*
+     |  DSatur за O((n+m) log n)                                   |
+     |                                                             |
+     |  Очередь: по куче на каждую сатурацию, ключ — степень       |
+     |  (при равенстве — меньший номер). При росте сатурации       |
+     |  вершина просто кладётся в кучу следующего уровня, старая   |
+     |  запись остаётся и отбрасывается при извлечении («ленивое»   |
+     |  удаление). Записей не больше n + 2m.                        |
+     |                                                             |
+     |  Цвета соседей: у вершины u бит на каждый цвет 0…deg(u) в   |
+     |  общем массиве (Σ(deg+1) бит); больших цветов у соседей     |
+     |  почти не бывает, они идут в хеш-множество переполнения.    |
+     *-----------------------------------------------------------*/
     static std::vector<int>
-    colorAdj(const std::vector<std::vector<int>>& g)
+    colorAdj(const CsrGraph& g)
     {
         const int n = static_cast<int>(g.size());
-        std::vector<int> degree(n), satDeg(n), color(n, -1);
-        for (int v = 0; v < n; ++v) degree[v] = static_cast<int>(g[v].size());
+        std::vector<int> degree(n), satDeg(n, 0), color(n, -1);
+        int maxDeg = 0;
+        for (int v = 0; v < n; ++v) {
+            degree[v] = static_cast<int>(g.degree(v));
+            maxDeg    = std::max(maxDeg, degree[v]);
+        }
+
+        /* ---------- кучи по сатурации ---------- */
+        using Key = std::uint64_t;                  // степень << 32 | ~v
+        auto key = [&](int v) {
+            return (static_cast<Key>(degree[v]) << 32) | (0xFFFFFFFFu - static_cast<std::uint32_t>(v));
+        };
+        auto vertexOf = [](Key k) { return static_cast<int>(0xFFFFFFFFu - static_cast<std::uint32_t>(k)); };
 
-        /* ---------- бакет-куча по сатурации ---------- */
-        std::vector<std::vector<int>> bucket(n + 1);
-        for (int v = 0; v < n; ++v) bucket[0].push_back(v);
+        std::vector<std::vector<Key>> heap(maxDeg + 2);
+        heap[0].reserve(n);
+        for (int v = 0; v < n; ++v) heap[0].push_back(key(v));
+        std::make_heap(heap[0].begin(), heap[0].end());
         int curMaxSat = 0;
 
         auto pop_max = [&]() -> int {
-            while (curMaxSat >= 0 && bucket[curMaxSat].empty()) --curMaxSat;
-            auto &vec = bucket[curMaxSat];
-            /*   tie-break: берём вершину с наибольшей степенью   */
-            auto it = std::max_element(vec.begin(), vec.end(),
-                       [&](int a,int b){ return degree[a] < degree[b]; });
-            int v = *it;
-            vec.erase(it);
-            return v;
+            for (;;) {
+                while (heap[curMaxSat].empty()) --curMaxSat;
+                auto& h = heap[curMaxSat];
+                std::pop_heap(h.begin(), h.end());
+                const int v = vertexOf(h.back());
+                h.pop_back();
+                if (color[v] == -1 && satDeg[v] == curMaxSat) return v;   // иначе запись устарела
+            }
+        };
+
+        /* ---------- цвета соседей ---------- */
+        std::vector<std::size_t> seenBase(n + 1, 0);
+        for (int v = 0; v < n; ++v) seenBase[v + 1] = seenBase[v] + degree[v] + 1;
+        std::vector<std::uint64_t> seen((seenBase[n] + 63) / 64, 0);
+        std::unordered_set<std::uint64_t> seenOverflow;
+
+        /* true, если цвет c у соседей u встретился впервые */
+        auto markSeen = [&](int u, int c) -> bool {
+            if (c <= degree[u]) {
+                const std::size_t bit = seenBase[u] + c;
+                std::uint64_t& w = seen[bit >> 6];
+                const std::uint64_t m = std::uint64_t{1} << (bit & 63);
+                if (w & m) return false;
+                w |= m;
+                return true;
+            }
+            return seenOverflow.insert((static_cast<std::uint64_t>(u) << 32) | static_cast<std::uint32_t>(c)).second;
         };
 
         /* ---------- служебные массивы ---------- */
-        std::vector<int> mark(n, 0);      // занятые цвета
-        int stamp = 1, colored = 0;
+        std::vector<int> mark(maxDeg + 2, 0);  // занятые цвета
+        int stamp = 1;
 
         /* ---------- DSatur ---------- */
-        while (colored < n)
+        for (int colored = 0; colored < n; ++colored)
         {
             int v = pop_max();
-            if (color[v] != -1) continue; // мог быть перекрашен
 
-            /* помечаем цвета соседей */
-            for (int u : g[v])
+            /* помечаем цвета соседей: все они ≤ maxDeg */
+            for (auto u : g.neighbours(v))
                 if (color[u] != -1) mark[color[u]] = stamp;
 
             int c = 0; while (mark[c] == stamp) ++c;
             color[v] = c;                     // красим
-            ++stamp; ++colored;
+            ++stamp;
 
             /* обновляем сатурации соседей */
-            for (int u : g[v]) if (color[u] == -1)
+            for (auto u : g.neighbours(v)) if (color[u] == -1)
             {
-                bool newColor = true;
-                for (int w : g[u]) if (color[w] == c) { newColor = false; break; }
-                if (!newColor) continue;
-
-                int& sd = satDeg[u];
-                auto& vec = bucket[sd];                     // убираем из старого
-                vec.erase(std::remove(vec.begin(), vec.end(), u), vec.end());
+                if (!markSeen(u, c)) continue;          // цвет у u уже был
 
-                ++sd;                                       // ↑ сатурация
-                bucket[sd].push_back(u);                    // кладём в новый
+                int& sd = ++satDeg[u];                  // ↑ сатурация
+                heap[sd].push_back(key(u));
+                std::push_heap(heap[sd].begin(), heap[sd].end());
                 curMaxSat = std::max(curMaxSat, sd);
             }
         }
@@ -68,22 +110,16 @@ private:
 
 public:        
 
+    /* --- CSR --- */
+    static std::vector<int> color(const CsrGraph& g)
+    { return colorAdj(g); }
+
     /* --- списки смежности --- */
     static std::vector<int> color(const std::vector<std::vector<int>>& g)
-    { return colorAdj(g); }
+    { return colorAdj(CsrGraph::fromAdjacency(g)); }
 
     /* --- 0/1-матрица (Eigen, std::vector, ...) --- */
     template<class Matrix>
     static auto color(const Matrix& M) -> decltype(M.rows(), std::vector<int>())
-    {
-        const int n = M.rows();
-        std::vector<std::vector<int>> adj(n);
-        for (int i = 0; i < n; ++i)
-            for (int j = 0; j < n; ++j)
-                if (M(i,j)){ 
-                    adj[i].push_back(j);
-                    adj[j].push_back(i);
-                }
-        return colorAdj(adj);
-    }
+    { return colorAdj(CsrGraph::fromDense(M)); }
 };
@@ -3,37 +3,27 @@
 #include <algorithm>
 #include <numeric>
 
+#include "../CsrGraph.h"
+
 class GreedyColoring
 {
 public:
-    template<class Matrix>
-    static std::vector<int> color(const Matrix& adj) {
-        const int n = adj.rows();
-
-        /* ---------- 1. строим списки смежности и степени ------------------ */
-        std::vector<std::vector<int>> g(n);
-        std::vector<int> degree(n,0);
-        for (int i=0;i<n;++i)
-            for (int j=0;j<n;++j)
-                if (i!=j && adj(i,j)) { 
-                    g[i].push_back(j);
-                    g[j].push_back(i);   
-                    ++degree[i]; 
-                }
-
-        /* ---------- 2. Welsh–Powell порядок (степень ↓) ------------------- */
+    static std::vector<int> color(const CsrGraph& g) {
+        const int n = static_cast<int>(g.size());
+
+        /* ---------- 1. Welsh–Powell порядок (степень ↓) ------------------- */
         std::vector<int> order(n);
         std::iota(order.begin(), order.end(), 0);
         std::sort(order.begin(), order.end(),
-                  [&](int a,int b){ return degree[a] > degree[b]; });
+                  [&](int a,int b){ return g.degree(a) > g.degree(b); });
 
-        /* ---------- 3. greedy coloring ------------------------------------ */
+        /* ---------- 2. greedy coloring ------------------------------------ */
         std::vector<int> color(n, -1);
         std::vector<int> mark(n, 0);   // mark[c] == stamp → цвет c занят
         int stamp = 1;
 
         for (int v : order) {
-            for (int u : g[v])
+            for (auto u : g.neighbours(v))
                 if (color[u] != -1) mark[color[u]] = stamp;
 
             int c = 0;
@@ -44,4 +34,10 @@ public:
         }
         return color;                  // χ = 1 + *max(color)*
     }
+
+    /* 0/1-матрица: приводим к CSR */
+    template<class Matrix>
+    static std::vector<int> color(const Matrix& adj) {
+        return color(CsrGraph::fromDense(adj));
+    }
 };
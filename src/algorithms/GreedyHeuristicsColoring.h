@@ -1,56 +1,86 @@
 #pragma once
+#include <atomic>
 #include <vector>
 #include <algorithm>
 #include <random>
-#include <unordered_map>
 #include <numeric>
+#include <cmath>
+#include <thread>
+
+#include "../CsrGraph.h"
+#include "../WorkStealingPool.h"
+#include "ParallelBnB.h"
 
 namespace greedy {
 
 /* ---------- результат ---------- */
 struct ColoringResult {
     int chromaticNumber = 0;                 // χ
-    std::unordered_map<int,int> colorOf;     // v → цвет (1-based)
+    std::vector<int> colorOf;                // colorOf[v] — цвет (1-based)
 };
 
+/* ---------- граф для Coloring: CSR как есть, матрица — через fromDense ---- */
+inline const CsrGraph& toCsr(const CsrGraph& g) { return g; }
+
+template<class Matrix>
+CsrGraph toCsr(const Matrix& M) { return CsrGraph::fromDense(M); }
+
 /* ---------- основной класс ----- */
+/*
+ * Жадная раскраска по набору порядков (~2√n+5), берётся лучшая.
+ *
+ * Порядки раскрашиваются параллельно на пуле из threads потоков
+ * (0 — по числу ядер), у каждого рабочего свои буферы. Рекорд —
+ * pbnb::SharedIncumbent: ключ (χ, номер порядка), поэтому при
+ * равных χ побеждает более ранний порядок, как и в прежнем
+ * последовательном цикле, и результат не зависит от расписания.
+ * Порядок бросается, как только открыл цвет, с которым уже не
+ * может победить; если рекорд равен lowerBound, оставшиеся
+ * порядки с большими номерами не запускаются.
+ *
+ * stop — внешняя остановка (Portfolio.h): когда *stop == true, новые
+ * порядки не запускаются, а начатые бросаются; результат — лучшая
+ * раскраска к этому моменту (пустая, если её ещё нет).
+ */
 template<class Matrix>
 class Coloring
 {
 public:
-    explicit Coloring(const Matrix& M, int maxColor = 10000)
-        : n_(M.rows()), maxColor_(maxColor)
+    explicit Coloring(const Matrix& M, int maxColor = 10000,
+                      unsigned threads = 0, int lowerBound = 0,
+                      const std::atomic<bool>* stop = nullptr)
+        : g_(toCsr(M)), n_(static_cast<int>(g_.size())), maxColor_(maxColor),
+          threads_(threads), lowerBound_(lowerBound), stop_(stop)
     {
-        buildAdjacency(M);
         calculate();
     }
 
     int  chromaticNumber()  const { return result_.chromaticNumber; }
-    const std::unordered_map<int,int>& colors() const { return result_.colorOf; }
+    const std::vector<int>& colors() const { return result_.colorOf; }
 
     /* статический шорт-кат, если объект класс не нужен */
-    static ColoringResult run(const Matrix& M, int maxColor = 1000)
+    static ColoringResult run(const Matrix& M, int maxColor = 1000,
+                              unsigned threads = 0, int lowerBound = 0)
     {
-        return Coloring(M, maxColor).result_;
+        return Coloring(M, maxColor, threads, lowerBound).result_;
     }
 
 private:
     /* ---------- данные ---------- */
+    CsrGraph g_;                               // граф (CSR)
     int n_;                                    // |V|
     int maxColor_;
-    std::vector<std::vector<int>> adj_;        // списки смежности
+    unsigned threads_;
+    int lowerBound_;                           // χ ≥ lowerBound_
+    const std::atomic<bool>* stop_;            // внешняя остановка или nullptr
     ColoringResult result_;
 
-    /* ---------- строим adj из матрицы ---- */
-    void buildAdjacency(const Matrix& A) {
-        adj_.assign(n_, {});
-        for (int i = 0; i < n_; ++i)
-            for (int j = i + 1; j < n_; ++j)
-                if (A(i,j)) {              
-                    adj_[i].push_back(j);
-                    adj_[j].push_back(i);
-                }
-    }
+    /* буферы одного рабочего */
+    struct Scratch {
+        std::vector<int> color;                // 0 — не окрашена
+        std::vector<int> mark;                 // mark[c] == stamp → цвет c занят
+        int stamp = 0;
+    };
 
     /* ---------- главный цикл ------------- */
     void calculate() {
@@ -62,31 +92,59 @@ private:
         addBasedOnDegree(orders);
         addForTree(orders);
 
-        int best = maxColor_;
-        for (const auto& ord : orders) {
-            auto cur = makeColoring(ord);
-            if (cur.chromaticNumber < best) {
-                best   = cur.chromaticNumber;
-                result_ = std::move(cur);
-            }
+        /* тривиальная нижняя граница: 1 цвет, 2 при наличии ребра */
+        const int lb = std::max(lowerBound_, n_ == 0 ? 0 : (g_.edges() ? 2 : 1));
+
+        pbnb::SharedIncumbent inc(maxColor_, {});
+        auto evaluate = [&](std::size_t t, Scratch& s) {
+            pbnb::SharedIncumbent::View view(inc, static_cast<std::uint32_t>(t));
+            if (view.bound() <= lb) return;    // рекорд уже на нижней границе
+            if (stopped()) return;
+            makeColoring(orders[t], s, view);
+        };
+
+        const unsigned threads = threads_ ? threads_
+                               : std::max(1u, std::thread::hardware_concurrency());
+        if (threads == 1 || orders.size() == 1) {
+            Scratch s;
+            for (std::size_t t = 0; t < orders.size(); ++t) evaluate(t, s);
+        } else {
+            WorkStealingPool pool(threads);
+            std::vector<Scratch> scratch(pool.size());
+            /* в обратном порядке: ранние порядки идут первыми (см. runTasks) */
+            for (std::size_t t = orders.size(); t-- > 0; )
+                pool.submit([&, t]{ evaluate(t, scratch[pool.workerIndex()]); });
+            pool.wait();
         }
+
+        result_.colorOf = std::move(inc.best());
+        result_.chromaticNumber = result_.colorOf.empty() ? 0
+            : *std::max_element(result_.colorOf.begin(), result_.colorOf.end());
     }
 
+    bool stopped() const { return stop_ && stop_->load(std::memory_order_relaxed); }
+
     /* ---------- жадная раскраска ---------- */
-    ColoringResult makeColoring(const std::vector<int>& order) const {
-        ColoringResult res;
+    template<class Incumbent>
+    void makeColoring(const std::vector<int>& order, Scratch& s, Incumbent& inc) const {
+        s.color.assign(n_, 0);
+        s.mark.assign(n_ + 2, 0);
+        s.stamp = 0;
+
         int bestColor = 0;
         for (int v : order) {
-            std::unordered_map<int,bool> used;
-            for (int nb : adj_[v])
-                if (res.colorOf.count(nb)) used[ res.colorOf.at(nb) ] = true;
-
-            int c = 1; while (used.count(c)) ++c;
-            res.colorOf[v] = c;
-            bestColor = std::max(bestColor, c);
+            ++s.stamp;
+            for (auto nb : g_.neighbours(v))
+                if (s.color[nb]) s.mark[s.color[nb]] = s.stamp;
+
+            int c = 1; while (s.mark[c] == s.stamp) ++c;
+            s.color[v] = c;
+            if (c > bestColor) {
+                bestColor = c;
+                if (bestColor >= inc.bound() || stopped()) return;   // уже не победит / стоп
+            }
         }
-        res.chromaticNumber = bestColor;
-        return res;
+        inc.offer(bestColor, s.color);
     }
 
     /* ---------- генерация порядков -------- */
@@ -105,7 +163,7 @@ private:
     void addBasedOnDegree(std::vector<std::vector<int>>& lst) const {
         struct VD { int v; int deg; };
         std::vector<VD> vd;
-        for (int v = 0; v < n_; ++v) vd.push_back({v, static_cast<int>(adj_[v].size())});
+        for (int v = 0; v < n_; ++v) vd.push_back({v, static_cast<int>(g_.degree(v))});
         std::sort(vd.begin(), vd.end(), [](auto&a,auto&b){ return a.deg>b.deg; });
         std::vector<int> order; for (auto& t:vd) order.push_back(t.v);
         lst.push_back(order);
@@ -123,7 +181,7 @@ private:
             std::shuffle(half.begin()+mid, half.end(), rng);
             lst.push_back(half);
 
-            int extra = static_cast<int>(std::sqrt(n));
+            int extra = n>2 ? static_cast<int>(std::sqrt(n)) : 0;   // pivot ∈ [1, n-2]
             for (int t=0;t<extra;++t) {
                 int pivot = 1 + rng()%(n-2);
                 auto tmp = order;
@@ -137,7 +195,7 @@ private:
     void addForTree(std::vector<std::vector<int>>& lst) const {
         struct VD { int v; int deg; };
         std::vector<VD> vd;
-        for (int v=0; v<n_; ++v) vd.push_back({v, static_cast<int>(adj_[v].size())});
+        for (int v=0; v<n_; ++v) vd.push_back({v, static_cast<int>(g_.degree(v))});
         std::sort(vd.begin(), vd.end(), [](auto&a,auto&b){return a.deg>b.deg;});
         std::vector<int> vdOrder; for(auto&x:vd) vdOrder.push_back(x.v);
 
@@ -154,9 +212,9 @@ private:
                     for(size_t qi=0;qi<qs;++qi){
                         int v=q[qi];
                         int bestNb=-1, bestDeg=-1;
-                        for(int nb: adj_[v]) if(!added[nb]){
+                        for(auto nb: g_.neighbours(v)) if(!added[nb]){
                             if(!pickMax){ bestNb=nb; break; }
-                            if(static_cast<int>(adj_[nb].size())>bestDeg){bestDeg=adj_[nb].size(); bestNb=nb;}
+                            if(static_cast<int>(g_.degree(nb))>bestDeg){bestDeg=g_.degree(nb); bestNb=nb;}
                         }
                         if(bestNb!=-1){ added[bestNb]=1; q.push_back(bestNb); res.push_back(bestNb); progress=true; break;}  
                     }
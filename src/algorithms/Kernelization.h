@@ -0,0 +1,199 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "../CsrGraph.h"
+#include "MaxClique.h"
+
+/*---------------------------------------------------------------*
+ |  Сокращение графа (ядро) перед точной раскраской               |
+ |                                                                |
+ |  LB — нижняя граница χ (клика или заданная). Правила, пока     |
+ |  хоть одно срабатывает:                                        |
+ |    LowDegree — deg(v) < LB: v снимается; при возврате у неё    |
+ |        меньше LB окрашенных соседей, и свободный цвет < LB     |
+ |        найдётся всегда;                                        |
+ |    Dominated — u, v не смежны и N(u) ⊆ N(v): u снимается и     |
+ |        при возврате получает цвет v.                           |
+ |  Ни одно правило не добавляет цветов сверх max(χ ядра, LB),    |
+ |  поэтому оптимальная раскраска ядра даёт оптимальную            |
+ |  раскраску графа.                                              |
+ |                                                                |
+ |  Снятые вершины кладутся в стек; lift() возвращает их в        |
+ |  обратном порядке — к моменту возврата окрашены ровно те       |
+ |  соседи, что были живы при снятии.                              |
+ |                                                                |
+ |  Кандидаты в доминирующие для u — соседи её соседа w с          |
+ |  наименьшей степенью (v обязан быть смежен с w), так что        |
+ |  проверка стоит Σ deg(w)·deg(u)·log, а не n².                   |
+ *---------------------------------------------------------------*/
+namespace kernel
+{
+
+enum Rule : int
+{
+    LowDegree,
+    Dominated,
+    kRuleCount
+};
+
+inline const char* ruleName(int r)
+{
+    static const char* const names[kRuleCount] = {"low_degree", "dominated"};
+    return names[r];
+}
+
+class Kernel
+{
+public:
+    struct Step
+    {
+        int vertex;
+        int dominator;                  // -1 — LowDegree
+    };
+
+    // lowerBound — известная нижняя граница χ (0 — только клика)
+    explicit Kernel(const CsrGraph& g, int lowerBound = 0)
+        : g_(g), n_(static_cast<int>(g.size())), alive_(n_, 1), deg_(n_)
+    {
+        lb_ = std::max(lowerBound, n_ == 0 ? 0 : (g.edges() ? 2 : 1));
+        if (n_ > 0)                     // при n > MaxClique::kDenseMaxN — жадная клика
+            lb_ = std::max(lb_, static_cast<int>(MaxClique::find(g).size()));
+        for (int v = 0; v < n_; ++v) deg_[v] = static_cast<int>(g.degree(v));
+
+        for (int v = 0; v < n_; ++v)
+            if (deg_[v] < lb_) queue_.push_back(v);
+        drain();
+
+        for (bool changed = true; changed; ) {
+            changed = false;
+            for (int u = 0; u < n_; ++u) {
+                if (!alive_[u]) continue;
+                const int v = dominator(u);
+                if (v < 0) continue;
+                remove(u, v);
+                drain();
+                changed = true;
+            }
+        }
+        build();
+    }
+
+    int lowerBound() const { return lb_; }
+
+    // ядро и его вершины в исходных номерах (по возрастанию)
+    const CsrGraph&         reduced() const { return reduced_; }
+    const std::vector<int>& kept()    const { return kept_; }
+
+    const std::vector<Step>& steps() const { return steps_; }
+    std::size_t removed()            const { return steps_.size(); }
+    std::size_t removedBy(int rule)  const { return byRule_[rule]; }
+
+    // раскраска ядра (0-based, по номерам ядра) → раскраска графа
+    std::vector<int> lift(const std::vector<int>& reducedColouring) const
+    {
+        std::vector<int> col(n_, -1);
+        for (std::size_t k = 0; k < kept_.size(); ++k) col[kept_[k]] = reducedColouring[k];
+
+        std::vector<int> mark(n_ + 1, 0);
+        int stamp = 0;
+        for (auto it = steps_.rbegin(); it != steps_.rend(); ++it) {
+            if (it->dominator >= 0) {
+                col[it->vertex] = col[it->dominator];
+                continue;
+            }
+            ++stamp;
+            for (auto u : g_.neighbours(it->vertex))
+                if (col[u] >= 0 && col[u] <= n_) mark[col[u]] = stamp;
+            int c = 0;
+            while (mark[c] == stamp) ++c;
+            col[it->vertex] = c;
+        }
+        return col;
+    }
+
+private:
+    const CsrGraph&   g_;               // должен пережить Kernel (нужен lift)
+    int               n_;
+    int               lb_ = 0;
+    std::vector<char> alive_;
+    std::vector<int>  deg_;             // степень среди живых
+    std::vector<int>  queue_;           // кандидаты LowDegree
+
+    std::vector<Step>                     steps_;
+    std::array<std::size_t, kRuleCount>   byRule_{};
+    CsrGraph                              reduced_;
+    std::vector<int>                      kept_;
+
+    void remove(int v, int dominator)
+    {
+        alive_[v] = 0;
+        steps_.push_back({v, dominator});
+        ++byRule_[dominator < 0 ? LowDegree : Dominated];
+        for (auto u : g_.neighbours(v))
+            if (alive_[u] && --deg_[u] < lb_) queue_.push_back(static_cast<int>(u));
+    }
+
+    void drain()
+    {
+        while (!queue_.empty()) {
+            const int v = queue_.back();
+            queue_.pop_back();
+            if (alive_[v]) remove(v, -1);
+        }
+    }
+
+    /* живая v ≠ u, не смежная с u, с N(u) ⊆ N(v); -1 — нет такой */
+    int dominator(int u) const
+    {
+        int w = -1;
+        for (auto x : g_.neighbours(u))
+            if (alive_[x] && (w < 0 || deg_[x] < deg_[w])) w = static_cast<int>(x);
+        if (w < 0) return -1;                          // изолированная — дело LowDegree
+
+        for (auto v : g_.neighbours(w)) {
+            if (!alive_[v] || static_cast<int>(v) == u || deg_[v] < deg_[u]) continue;
+            if (g_.areAdjacent(u, v)) continue;
+            bool covers = true;
+            for (auto x : g_.neighbours(u))
+                if (alive_[x] && !g_.areAdjacent(v, x)) { covers = false; break; }
+            if (covers) return static_cast<int>(v);
+        }
+        return -1;
+    }
+
+    /* живые вершины по возрастанию номеров: списки остаются отсортированными */
+    void build()
+    {
+        std::vector<int> index(n_, -1);
+        for (int v = 0; v < n_; ++v)
+            if (alive_[v]) {
+                index[v] = static_cast<int>(kept_.size());
+                kept_.push_back(v);
+            }
+
+        std::vector<CsrGraph::Offset> offsets{0};
+        std::vector<CsrGraph::Vertex> adj;
+        offsets.reserve(kept_.size() + 1);
+        for (int v : kept_) {
+            for (auto u : g_.neighbours(v))
+                if (alive_[u]) adj.push_back(static_cast<CsrGraph::Vertex>(index[u]));
+            offsets.push_back(adj.size());
+        }
+        reduced_ = CsrGraph(std::move(offsets), std::move(adj));
+    }
+};
+
+/*---------------------------------------------------------------*
+ |  colour: ядро → solve(ядро) → раскраска графа (0-based)        |
+ *---------------------------------------------------------------*/
+template<class Solve>
+std::vector<int> colour(const CsrGraph& g, Solve&& solve, int lowerBound = 0)
+{
+    const Kernel k(g, lowerBound);
+    return k.lift(k.reduced().size() ? solve(k.reduced()) : std::vector<int>{});
+}
+
+} // namespace kernel
@@ -3,119 +3,263 @@
 #include <vector>
 #include <algorithm>
 #include <numeric>
-#include <functional>
+
+#include "../CsrGraph.h"
+#include "../SearchStats.h"
+#include "ParallelBnB.h"
 
 namespace detail {
 /* Welsh–Powell greedy (0-based) */
-template<class Matrix>
-std::vector<int> greedyColor(const Matrix& A)
+inline std::vector<int> greedyColor(const CsrGraph& g)
 {
-    const int n = A.rows();
-    std::vector<std::vector<int>> g(n);
-    std::vector<int> deg(n,0);
-    for (int i=0;i<n;++i)
-        for (int j=0;j<n;++j)
-            if (A(i,j)) { g[i].push_back(j); ++deg[i]; }
-
+    const int n = static_cast<int>(g.size());
     std::vector<int> ord(n); std::iota(ord.begin(),ord.end(),0);
     std::sort(ord.begin(),ord.end(),
-              [&](int a,int b){ return deg[a]>deg[b]; });
+              [&](int a,int b){ return g.degree(a)>g.degree(b); });
 
     std::vector<int> col(n,-1), mark(n,0); int stamp=1;
     for (int v:ord)
     {
-        for (int u:g[v]) if (col[u]!=-1) mark[col[u]]=stamp;
+        for (auto u:g.neighbours(v)) if (col[u]!=-1) mark[col[u]]=stamp;
         int c=0; while (mark[c]==stamp) ++c;
         col[v]=c; ++stamp;
     }
     return col;
 }
+
+template<class Matrix>
+std::vector<int> greedyColor(const Matrix& A)
+{
+    return greedyColor(CsrGraph::fromDense(A));
+}
 } // namespace detail
 
 
 /*---------------------------------------------------------------*
  |  exact DSATUR + Branch-and-Bound                              |
+ |                                                               |
+ |  stats (если задан): узел — вызов dfs, глубина — число        |
+ |  окрашенных вершин; первый рекорд — жадная оценка.            |
  *---------------------------------------------------------------*/
 class BacktrackingColoring
 {
 public:
+    static std::vector<int> color(const CsrGraph& g, SearchStats* stats = nullptr)
+    {
+        SearchStats st;
+        const Problem P(g);
+        st.setupSeconds = st.seconds();
+        st.improved(P.UB);
+
+        pbnb::SerialIncumbent inc(P.UB, P.greedy);
+        const auto t0 = SearchStats::Clock::now();
+        Search<pbnb::SerialIncumbent>(P, inc, st).run();
+        st.searchSeconds = SearchStats::since(t0);
+        if (stats) *stats = std::move(st);
+        return inc.best();     // 0-based (добавьте +1 при выводе, если нужно)
+    }
+
+    /* то же на пуле из threads потоков (0 — по числу ядер), см. ParallelBnB.h */
+    static std::vector<int> colorParallel(const CsrGraph& g, unsigned threads = 0,
+                                          SearchStats* stats = nullptr)
+    {
+        SearchStats st;
+        const Problem P(g);
+        st.improved(P.UB);
+
+        std::vector<pbnb::Prefix> prefixes;
+        for (int depth = 1; depth <= P.n; ++depth)
+        {
+            pbnb::SerialIncumbent probe(P.UB, P.greedy);
+            prefixes.clear();
+            Search<pbnb::SerialIncumbent>(P, probe, st).run(depth, &prefixes);
+
+            bool deeper = false;
+            for (const auto& pr : prefixes)
+                if ((int)pr.size() < P.n) { deeper = true; break; }
+            if (prefixes.size() >= pbnb::kTargetTasks || !deeper) break;
+        }
+        st.setupSeconds = st.seconds();
+
+        std::vector<SearchStats> taskStats(prefixes.size());
+        for (auto& ts : taskStats) ts.start = st.start;
+
+        const auto t0 = SearchStats::Clock::now();
+        pbnb::SharedIncumbent inc(P.UB, P.greedy);
+        pbnb::runTasks(prefixes, inc, threads,
+            [&](std::size_t t, const pbnb::Prefix& prefix, pbnb::SharedIncumbent::View& view)
+            {
+                Search<pbnb::SharedIncumbent::View> search(P, view, taskStats[t]);
+                search.replay(prefix);
+                search.run();
+            });
+        for (const auto& ts : taskStats) st.merge(ts);
+        st.searchSeconds = SearchStats::since(t0);
+        if (stats) *stats = std::move(st);
+        return inc.best();
+    }
+
+    /* поиск с внешним рекордом (Portfolio.h), как DSaturBnB::colorWith:
+       своя жадная оценка — в inc, дальше только раскраски лучше bound() */
+    template<class Incumbent>
+    static void colorWith(const CsrGraph& g, Incumbent& inc, SearchStats* stats = nullptr)
+    {
+        SearchStats st;
+        const Problem P(g);
+        st.setupSeconds = st.seconds();
+        if (inc.offer(P.UB, P.greedy)) st.improved(P.UB);
+
+        const auto t0 = SearchStats::Clock::now();
+        Search<Incumbent>(P, inc, st).run();
+        st.searchSeconds = SearchStats::since(t0);
+        if (stats) *stats = std::move(st);
+    }
+
+    /* плотная матрица: приводим к CSR один раз */
     template<class Matrix>
-    static std::vector<int> color(const Matrix& A)
+    static std::vector<int> color(const Matrix& A, SearchStats* stats = nullptr)
+    {
+        return color(CsrGraph::fromDense(A), stats);
+    }
+
+    template<class Matrix>
+    static std::vector<int> colorParallel(const Matrix& A, unsigned threads = 0,
+                                          SearchStats* stats = nullptr)
+    {
+        return colorParallel(CsrGraph::fromDense(A), threads, stats);
+    }
+
+private:
+    /* adjacency + degree + greedy upper bound */
+    struct Problem
+    {
+        int n;
+        std::vector<std::vector<int>> adj;
+        std::vector<int> deg;
+        std::vector<int> greedy;
+        int UB;
+
+        explicit Problem(const CsrGraph& g) : n(static_cast<int>(g.size())), adj(n), deg(n,0)
+        {
+            for (int i=0;i<n;++i)
+            {
+                for (auto j : g.neighbours(i)) adj[i].push_back(static_cast<int>(j));
+                deg[i] = static_cast<int>(adj[i].size());
+            }
+
+            greedy = detail::greedyColor(g);
+            UB = n ? *std::max_element(greedy.begin(),greedy.end()) + 1 : 0;
+        }
+    };
+
+    /* DSATUR-перебор; Incumbent — рекорд (bound/offer, см. ParallelBnB.h) */
+    template<class Incumbent>
+    class Search
     {
-        const int n = A.rows();
-
-        /* adjacency + degree */
-        std::vector<std::vector<int>> adj(n);
-        std::vector<int> deg(n,0);
-        for (int i=0;i<n;++i)
-            for (int j=0;j<n;++j)
-                if (A(i,j)) { adj[i].push_back(j); ++deg[i]; }
-
-        /* greedy upper bound */
-        auto greedy = detail::greedyColor(A);
-        int UB = *std::max_element(greedy.begin(),greedy.end()) + 1;
-        std::vector<int> best = greedy;
-
-        /* DSATUR structures */
-        std::vector<int> sat(n,0);              // saturation degree
-        std::vector<int> col(n,-1);             // current colouring
-        std::vector<std::vector<int>> forbidCnt(n,std::vector<int>(n,0));
-
-        /* recursion */
-        std::function<void(int,int)> dfs = [&](int coloured,int used)
+    public:
+        Search(const Problem& P, Incumbent& inc, SearchStats& stats)
+            : P_(P), inc_(inc), stats_(stats), n_(P.n),
+              sat_(P.n,0), col_(P.n,-1),
+              forbidCnt_(P.n,std::vector<int>(P.n,0)) {}
+
+        // закрепить назначения префикса
+        void replay(const pbnb::Prefix& prefix)
+        {
+            for (const auto& [v,c] : prefix)
+            {
+                paint(v,c);
+                ++coloured_;
+                used_ = std::max(used_, c+1);
+            }
+        }
+
+        // при out != nullptr узлы глубины stopDepth (и листья выше неё)
+        // записываются префиксами в порядке DFS вместо раскрытия
+        void run(int stopDepth = -1, std::vector<pbnb::Prefix>* out = nullptr)
         {
-            if (used >= UB) return;             // bound
+            stopDepth_ = stopDepth;
+            out_       = out;
+            path_.clear();
+            dfs(coloured_, used_);
+        }
+
+    private:
+        const Problem& P_;
+        Incumbent&     inc_;
+        SearchStats&   stats_;
+        const int      n_;
+
+        std::vector<int> sat_;                        // saturation degree
+        std::vector<int> col_;                        // current colouring
+        std::vector<std::vector<int>> forbidCnt_;
+        int coloured_ = 0, used_ = 0;                 // после replay
 
-            if (coloured == n)                  // full solution
+        int                        stopDepth_ = -1;
+        std::vector<pbnb::Prefix>* out_       = nullptr;
+        pbnb::Prefix               path_;             // назначения после корня
+
+        void paint(int v,int c)
+        {
+            col_[v]=c;
+            for (int u:P_.adj[v])
+                if (col_[u]==-1)
+                    if (forbidCnt_[u][c]++ ==0) ++sat_[u];
+        }
+
+        void unpaint(int v,int c)
+        {
+            for (int u:P_.adj[v])
+                if (col_[u]==-1)
+                    if (--forbidCnt_[u][c]==0) --sat_[u];
+            col_[v]=-1;
+        }
+
+        void branch(int v,int c,int coloured,int used)
+        {
+            paint(v,c);
+            if (out_) path_.emplace_back(v,c);
+            dfs(coloured+1, used);
+            if (out_) path_.pop_back();
+            unpaint(v,c);
+        }
+
+        void dfs(int coloured,int used)
+        {
+            stats_.node(coloured);
+            if (used >= inc_.bound())                // bound
             {
-                UB   = used;
-                best = col;
+                stats_.prune(SearchStats::Bound);
+                return;
+            }
+
+            if (out_ && (coloured == stopDepth_ || coloured == n_))
+            {
+                out_->push_back(path_);
+                return;
+            }
+
+            if (coloured == n_)                      // full solution
+            {
+                if (inc_.offer(used, col_)) stats_.improved(used);
                 return;
             }
 
             /* choose vertex by DSATUR */
             int v=-1, bestSat=-1, bestDeg=-1;
-            for (int i=0;i<n;++i) if (col[i]==-1)
-                if (sat[i]>bestSat || (sat[i]==bestSat && deg[i]>bestDeg))
-                    { v=i; bestSat=sat[i]; bestDeg=deg[i]; }
+            for (int i=0;i<n_;++i) if (col_[i]==-1)
+                if (sat_[i]>bestSat || (sat_[i]==bestSat && P_.deg[i]>bestDeg))
+                    { v=i; bestSat=sat_[i]; bestDeg=P_.deg[i]; }
 
             /* try existing colours 0 … used-1 */
             for (int c=0;c<used;++c)
             {
-                if (forbidCnt[v][c]) continue;
-
-                col[v]=c;
-                for (int u:adj[v])
-                    if (col[u]==-1)
-                        if (forbidCnt[u][c]++ ==0) ++sat[u];
-
-                dfs(coloured+1, used);
-
-                for (int u:adj[v])
-                    if (col[u]==-1)
-                        if (--forbidCnt[u][c]==0) --sat[u];
-                col[v]=-1;
+                if (forbidCnt_[v][c]) continue;
+                branch(v,c,coloured,used);
             }
 
             /* try NEW colour = used (only if it can improve UB) */
-            if (used + 1 < UB)
-            {
-                int c = used;
-                col[v]=c;
-                for (int u:adj[v])
-                    if (col[u]==-1)
-                        if (forbidCnt[u][c]++ ==0) ++sat[u];
-
-                dfs(coloured+1, used+1);
-
-                for (int u:adj[v])
-                    if (col[u]==-1)
-                        if (--forbidCnt[u][c]==0) --sat[u];
-                col[v]=-1;
-            }
-        };
-
-        dfs(0,0);
-        return best;           // 0-based (добавьте +1 при выводе, если нужно)
-    }
+            if (used + 1 < inc_.bound())
+                branch(v,used,coloured,used+1);
+        }
+    };
 };
@@ -0,0 +1,235 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <vector>
+
+#include "../CsrGraph.h"
+#include "../method/Bitset.h"
+
+/*---------------------------------------------------------------*
+ |  Максимальная клика: ветви и границы на битовых строках        |
+ |  (схема BBMC). Вершины перенумерованы по убыванию степени,     |
+ |  оценка узла — жадная раскраска кандидатов; клика из k вершин  |
+ |  требует k цветов, поэтому её размер — нижняя граница χ.       |
+ |                                                                |
+ |  Поиск останавливается, как только клика достигла stopAt,      |
+ |  исчерпан бюджет узлов или поднят внешний флаг stop;           |
+ |  возвращается лучшая найденная клика (при срабатывании бюджета |
+ |  или stop — не обязательно максимальная).                      |
+ |                                                                |
+ |  Память: матрица n × stride слов и по строке P на уровень;     |
+ |  уровней не больше размера клики + 1, они заводятся по мере    |
+ |  спуска. При n > kDenseMaxN матрица не строится, и клика        |
+ |  ищется жадно по спискам CSR от вершин наибольшей степени.     |
+ *---------------------------------------------------------------*/
+namespace MaxClique
+{
+
+constexpr std::uint64_t kDefaultNodeLimit = std::uint64_t{1} << 20;
+
+// выше — без битовой матрицы (при 2^14 вершинах она занимает 32 МиБ)
+constexpr int kDenseMaxN = 1 << 14;
+
+// сколько стартовых вершин пробует жадная клика
+constexpr int kGreedyStarts = 256;
+
+/*-------- жадная клика по спискам CSR --------------------------*/
+inline std::vector<int> greedyClique(const CsrGraph& g, int starts = kGreedyStarts)
+{
+    const int n = static_cast<int>(g.size());
+    std::vector<int> byDegree(n);
+    std::iota(byDegree.begin(), byDegree.end(), 0);
+    const int top = std::min(n, starts);
+    std::partial_sort(byDegree.begin(), byDegree.begin() + top, byDegree.end(),
+                      [&](int a, int b){ return g.degree(a) > g.degree(b); });
+
+    std::vector<int> best, clique, cand;
+    for (int s = 0; s < top; ++s) {
+        const int v = byDegree[s];
+        if (static_cast<int>(g.degree(v)) + 1 <= static_cast<int>(best.size())) break;
+
+        cand.assign(g.neighbours(v).begin(), g.neighbours(v).end());
+        std::stable_sort(cand.begin(), cand.end(),
+                         [&](int a, int b){ return g.degree(a) > g.degree(b); });
+        clique.assign(1, v);
+        for (int u : cand) {
+            bool all = true;
+            for (int w : clique)
+                if (w != v && !g.areAdjacent(u, w)) { all = false; break; }
+            if (all) clique.push_back(u);
+        }
+        if (clique.size() > best.size()) best = clique;
+    }
+    std::sort(best.begin(), best.end());
+    return best;
+}
+
+class Solver
+{
+public:
+    explicit Solver(const CsrGraph& g)
+        : n_(static_cast<int>(g.size())),
+          W_(bits::wordsFor(n_)),
+          stride_(bits::strideFor(n_))
+    {
+        if (n_ > kDenseMaxN) {
+            greedy_ = greedyClique(g);
+            return;
+        }
+
+        /* — порядок: по убыванию степени, бит k ↔ вершина order_[k] — */
+        order_.resize(n_);
+        std::iota(order_.begin(), order_.end(), 0);
+        std::stable_sort(order_.begin(), order_.end(),
+                         [&](int a, int b){ return g.degree(a) > g.degree(b); });
+
+        std::vector<int> index(n_);
+        for (int k = 0; k < n_; ++k) index[order_[k]] = k;
+
+        adj_.assign(static_cast<std::size_t>(n_) * stride_, 0);
+        for (int a = 0; a < n_; ++a)
+            for (auto v : g.neighbours(order_[a]))
+                bits::set(row(a), index[v]);
+    }
+
+    template<class Matrix>
+    explicit Solver(const Matrix& A) : Solver(CsrGraph::fromDense(A)) {}
+
+    std::vector<int> find(int stopAt = INT_MAX,
+                          std::uint64_t nodeLimit = kDefaultNodeLimit,
+                          const std::atomic<bool>* stop = nullptr)
+    {
+        best_.clear();
+        cur_.clear();
+        stopAt_ = stopAt;
+        nodes_  = 0;
+        limit_  = nodeLimit;
+        stop_   = stop;
+        if (n_ == 0) return {};
+        if (n_ > kDenseMaxN) return greedy_;
+
+        /* по уровню: кандидаты P, рабочие U/Q раскраски, порядок и цвета */
+        level(0);
+        U_.assign(stride_, 0);
+        Q_.assign(stride_, 0);
+
+        std::fill(levels_[0].P.begin(), levels_[0].P.end(), 0);
+        for (int k = 0; k < n_; ++k) bits::set(levels_[0].P.data(), k);
+        expand(0);
+
+        std::vector<int> clique;
+        clique.reserve(best_.size());
+        for (int k : best_) clique.push_back(order_[k]);
+        std::sort(clique.begin(), clique.end());
+        return clique;
+    }
+
+    std::uint64_t nodes() const { return nodes_; }
+
+private:
+    struct Level
+    {
+        bits::WordVector P;
+        std::vector<int> verts;          // кандидаты в порядке раскраски
+        std::vector<int> bound;          // число цветов на префиксе
+    };
+
+    int n_, W_, stride_;
+    std::vector<int>   order_;
+    bits::WordVector   adj_;
+    std::deque<Level>  levels_;          // deque: ссылки на уровни стабильны
+    bits::WordVector   U_, Q_;
+    std::vector<int>   greedy_;          // клика при n > kDenseMaxN
+
+    std::vector<int> cur_, best_;
+    int              stopAt_ = INT_MAX;
+    std::uint64_t    nodes_ = 0, limit_ = 0;
+    const std::atomic<bool>* stop_ = nullptr;   // внешняя остановка (Portfolio.h)
+
+    bits::Word*       row(int k)       { return adj_.data() + static_cast<std::size_t>(k) * stride_; }
+    const bits::Word* row(int k) const { return adj_.data() + static_cast<std::size_t>(k) * stride_; }
+
+    // уровень depth, заведённый при первом спуске на него
+    Level& level(int depth)
+    {
+        while ((int)levels_.size() <= depth) {
+            levels_.emplace_back();
+            levels_.back().P.assign(stride_, 0);
+        }
+        return levels_[depth];
+    }
+
+    bool done() const
+    {
+        return (int)best_.size() >= stopAt_ || (limit_ && nodes_ >= limit_) ||
+               (stop_ && stop_->load(std::memory_order_relaxed));
+    }
+
+    /* жадная раскраска P: verts по классам, bound[i] — номер класса verts[i] */
+    void colourSort(Level& l)
+    {
+        l.verts.clear();
+        l.bound.clear();
+        std::copy(l.P.begin(), l.P.end(), U_.begin());
+        int k = 0;
+        while (bits::any(U_.data(), W_)) {
+            ++k;
+            std::copy(U_.begin(), U_.end(), Q_.begin());
+            for (int w = 0; w < W_; ++w)
+                while (Q_[w]) {
+                    const int v = w * bits::kWordBits + bits::ctz64(Q_[w]);
+                    bits::reset(U_.data(), v);
+                    bits::reset(Q_.data(), v);
+                    bits::andNotInto(Q_.data(), Q_.data(), row(v), W_);
+                    l.verts.push_back(v);
+                    l.bound.push_back(k);
+                }
+        }
+    }
+
+    void expand(int depth)
+    {
+        ++nodes_;
+        Level& l = levels_[depth];
+        colourSort(l);
+
+        /* с конца: у последних вершин самая большая оценка */
+        for (int i = (int)l.verts.size() - 1; i >= 0; --i) {
+            if ((int)cur_.size() + l.bound[i] <= (int)best_.size()) return;
+            if (done()) return;
+
+            const int v = l.verts[i];
+            cur_.push_back(v);
+            Level& next = level(depth + 1);
+            bits::andInto(next.P.data(), l.P.data(), row(v), W_);
+            if (bits::any(next.P.data(), W_))
+                expand(depth + 1);
+            else if (cur_.size() > best_.size())
+                best_ = cur_;
+            cur_.pop_back();
+            bits::reset(l.P.data(), v);
+        }
+    }
+};
+
+/* клика (исходные номера вершин, по возрастанию) */
+inline std::vector<int> find(const CsrGraph& g, int stopAt = INT_MAX,
+                             std::uint64_t nodeLimit = kDefaultNodeLimit,
+                             const std::atomic<bool>* stop = nullptr)
+{
+    return Solver(g).find(stopAt, nodeLimit, stop);
+}
+
+template<class Matrix>
+std::vector<int> find(const Matrix& A, int stopAt = INT_MAX,
+                      std::uint64_t nodeLimit = kDefaultNodeLimit,
+                      const std::atomic<bool>* stop = nullptr)
+{
+    return Solver(A).find(stopAt, nodeLimit, stop);
+}
+
+} // namespace MaxClique
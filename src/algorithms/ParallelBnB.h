@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "../WorkStealingPool.h"
+
+/*---------------------------------------------------------------*
+ |  Общая часть параллельных точных раскрасок (DSaturBnB,         |
+ |  BacktrackingColoring).                                        |
+ |                                                                |
+ |  Дерево поиска режется на небольшой глубине на префиксы —      |
+ |  последовательности назначений (вершина, цвет) в порядке DFS;  |
+ |  префикс с номером t становится задачей пула, которая          |
+ |  воспроизводит его на собственной копии состояния.             |
+ |                                                                |
+ |  Рекорд — упакованный ключ (χ << 32 | номер задачи + 1) под     |
+ |  atomic-min. Задача t ищет только решения, ключ которых меньше |
+ |  текущего, т. е. χ < best, либо χ == best при t < задачи       |
+ |  рекорда. Итог — минимальный ключ по всем задачам, и он не     |
+ |  зависит от расписания: одинаковые χ и раскраска в каждом      |
+ |  запуске. Жадная начальная раскраска имеет номер 0 и равными   |
+ |  ей решениями не вытесняется.                                  |
+ *---------------------------------------------------------------*/
+namespace pbnb
+{
+
+using Prefix = std::vector<std::pair<int, int>>;   // (вершина, цвет)
+
+// сколько префиксов нарезать: с запасом на кражу, но не зависит
+// от числа потоков — иначе результат зависел бы от него
+constexpr std::size_t kTargetTasks = 64;
+
+/*-------- последовательный рекорд: то же, что прежний UB --------*/
+class SerialIncumbent
+{
+public:
+    SerialIncumbent(int ub, std::vector<int> colouring)
+        : ub_(ub), best_(std::move(colouring)) {}
+
+    int  bound() const { return ub_; }         // отсекаем χ ≥ bound()
+    bool offer(int value, const std::vector<int>& colouring)
+    {
+        ub_   = value;
+        best_ = colouring;
+        return true;
+    }
+    std::vector<int>& best() { return best_; }
+
+private:
+    int              ub_;
+    std::vector<int> best_;
+};
+
+/*-------- общий рекорд параллельного поиска -------------------*/
+class SharedIncumbent
+{
+public:
+    SharedIncumbent(int ub, std::vector<int> colouring)
+        : key_(pack(ub, 0)), bestKey_(pack(ub, 0)), best_(std::move(colouring)) {}
+
+    std::vector<int>& best() { return best_; }
+
+    // взгляд задачи task (0-based) на рекорд
+    class View
+    {
+    public:
+        View(SharedIncumbent& s, std::uint32_t task) : s_(s), task_(task + 1) {}
+
+        int bound() const
+        {
+            const std::uint64_t k = s_.key_.load(std::memory_order_relaxed);
+            const int value = static_cast<int>(k >> 32);
+            return task_ < static_cast<std::uint32_t>(k) ? value + 1 : value;
+        }
+
+        // true — рекорд улучшен этим решением
+        bool offer(int value, const std::vector<int>& colouring)
+        {
+            const std::uint64_t k = pack(value, task_);
+            std::uint64_t cur = s_.key_.load(std::memory_order_relaxed);
+            while (k < cur)
+                if (s_.key_.compare_exchange_weak(cur, k, std::memory_order_relaxed)) {
+                    std::lock_guard<std::mutex> lk(s_.m_);
+                    if (k < s_.bestKey_) {             // записи могут прийти не по порядку
+                        s_.bestKey_ = k;
+                        s_.best_    = colouring;
+                    }
+                    return true;
+                }
+            return false;
+        }
+
+    private:
+        SharedIncumbent& s_;
+        std::uint32_t    task_;
+    };
+
+private:
+    std::atomic<std::uint64_t> key_;
+    std::mutex                 m_;                     // защищает bestKey_, best_
+    std::uint64_t              bestKey_;
+    std::vector<int>           best_;
+
+    static std::uint64_t pack(int value, std::uint32_t task)
+    {
+        return (static_cast<std::uint64_t>(value) << 32) | task;
+    }
+};
+
+/*---------------------------------------------------------------*
+ |  runTasks: solve(t, prefix, view) для каждого префикса на пуле |
+ |  из threads потоков (0 — по числу ядер)                        |
+ *---------------------------------------------------------------*/
+template<class Solve>
+void runTasks(const std::vector<Prefix>& prefixes, SharedIncumbent& inc,
+              unsigned threads, Solve&& solve)
+{
+    /* рабочий берёт свои задачи с хвоста деки: подаём в обратном
+       порядке, чтобы раньше шли ранние по DFS задачи — их рекорды
+       сильнее всего сужают границу для остальных                  */
+    WorkStealingPool pool(threads);
+    for (std::size_t t = prefixes.size(); t-- > 0; )
+        pool.submit([&, t]{
+            SharedIncumbent::View view(inc, static_cast<std::uint32_t>(t));
+            solve(t, prefixes[t], view);
+        });
+    pool.wait();
+}
+
+} // namespace pbnb
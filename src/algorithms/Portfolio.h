@@ -0,0 +1,280 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "../CsrGraph.h"
+#include "../SearchStats.h"
+#include "../method/Graph.h"
+#include "../method/OlemskoyColorGraph.h"
+#include "DSaturBnB.h"
+#include "DSaturColoring.h"
+#include "GreedyColoring.h"
+#include "GreedyHeuristicsColoring.h"
+#include "MISBacktracking.h"
+#include "MaxClique.h"
+
+/*---------------------------------------------------------------*
+ |  Портфель: все решатели наперегонки на одном графе             |
+ |                                                                |
+ |  Каждый решатель — в своём потоке: клика (нижняя граница),     |
+ |  Greedy, DSatur, greedy::Coloring, DSaturBnB, MIS-перебор и    |
+ |  метод Олемского. Общие у них:                                  |
+ |    UB и лучшая раскраска — любая найденная раскраска сразу     |
+ |        сужает границу точных переборов (они работают через     |
+ |        View, тот же bound/offer, что в ParallelBnB.h);          |
+ |    LB — клика, а точный перебор, дошедший до конца, доказывает |
+ |        LB = UB;                                                |
+ |    stop — поднимается, как только LB ≥ UB: View::bound() тогда |
+ |        падает до 0 и переборы сворачиваются за O(глубины),     |
+ |        Олемский проверяет флаг в каждом узле.                  |
+ |                                                                |
+ |  В Олемского UB не передаётся: его проверки A/B/C опираются на |
+ |  собственный рекорд, а bestPartition — на собственное         |
+ |  разбиение. Он отдаёт каждый свой рекорд в общий и            |
+ |  останавливается по stop, но его завершение не считается       |
+ |  доказательством оптимальности. Граф Олемского — n² бит, так   |
+ |  что он запускается только при n ≤ olemskoyMaxN.                |
+ *---------------------------------------------------------------*/
+namespace portfolio
+{
+
+enum Solver : int
+{
+    Clique,             // MaxClique — только нижняя граница
+    Greedy,
+    DSatur,
+    Heuristic,          // greedy::Coloring
+    BnB,                // DSaturBnB
+    Mis,                // BacktrackingColoring
+    Olemskoy,
+    kSolverCount
+};
+
+inline const char* solverName(int s)
+{
+    static const char* const names[kSolverCount] = {
+        "clique", "greedy", "dsatur", "heuristic", "bnb", "mis", "olemskoy"};
+    return names[s];
+}
+
+/* число цветов раскраски 0-based */
+inline int colourCount(const std::vector<int>& col)
+{
+    return col.empty() ? 0 : *std::max_element(col.begin(), col.end()) + 1;
+}
+
+/*-------- общие границы и флаг остановки ----------------------*/
+class Shared
+{
+public:
+    // начальный рекорд — каждой вершине свой цвет
+    explicit Shared(int n) : ub_(n), best_(n)
+    {
+        std::iota(best_.begin(), best_.end(), 0);
+    }
+
+    int  upper()   const { return ub_.load(std::memory_order_relaxed); }
+    int  lower()   const { return lb_.load(std::memory_order_relaxed); }
+    bool stopped() const { return stop_.load(std::memory_order_relaxed); }
+    const std::atomic<bool>* stopFlag() const { return &stop_; }
+
+    // true — рекорд улучшен; colouring 0-based
+    bool offer(int value, const std::vector<int>& colouring, int solver)
+    {
+        if (value >= upper()) return false;
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            if (value >= upper()) return false;        // ub_ меняется только под m_
+            best_   = colouring;
+            winner_ = solver;
+            timeline_.improved(value);
+            ub_.store(value, std::memory_order_relaxed);
+        }
+        settle();
+        return true;
+    }
+
+    void raiseLower(int value)
+    {
+        int cur = lower();
+        while (value > cur && !lb_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+        settle();
+    }
+
+    /* рекорд глазами решателя: bound/offer, как в ParallelBnB.h */
+    class View
+    {
+    public:
+        View(Shared& s, int solver) : s_(s), solver_(solver) {}
+
+        int  bound() const { return s_.stopped() ? 0 : s_.upper(); }
+        bool offer(int value, const std::vector<int>& colouring)
+        {
+            return s_.offer(value, colouring, solver_);
+        }
+
+    private:
+        Shared& s_;
+        int     solver_;
+    };
+
+    // вызывать после того, как все решатели остановлены
+    std::vector<int> best()     const { return best_; }
+    int              winner()   const { return winner_; }
+    const SearchStats& timeline() const { return timeline_; }
+
+private:
+    std::atomic<int>  ub_;
+    std::atomic<int>  lb_{0};
+    std::atomic<bool> stop_{false};
+
+    std::mutex       m_;                           // best_, winner_, timeline_
+    std::vector<int> best_;
+    int              winner_ = -1;                 // -1 — тривиальная раскраска
+    SearchStats      timeline_;                    // рекорды по времени
+
+    void settle()
+    {
+        if (lower() >= upper()) stop_.store(true, std::memory_order_relaxed);
+    }
+};
+
+struct Options
+{
+    bool heuristics = true;                        // Greedy, DSatur, greedy::Coloring
+    bool bnb        = true;
+    bool mis        = true;
+    bool olemskoy   = true;
+    int  olemskoyMaxN = 200;
+    unsigned heuristicThreads = 1;                 // пул greedy::Coloring
+};
+
+struct Result
+{
+    std::vector<int> colouring;                    // 0-based
+    int  chi        = 0;                           // UB
+    int  lowerBound = 0;                           // LB
+    bool optimal    = true;                        // LB == UB
+    int  winner     = -1;                          // чья раскраска; -1 — тривиальная
+
+    // по решателям: секунды от старта до выхода (< 0 — не запускался)
+    // и закончил ли он сам, а не по stop
+    std::array<double, kSolverCount> seconds;
+    std::array<bool,   kSolverCount> completed{};
+
+    // рекорды всех решателей по времени; узлы и отсечения — сумма
+    // точных переборов
+    SearchStats stats;
+
+    Result() { seconds.fill(-1.0); }
+};
+
+/*---------------------------------------------------------------*
+ |  solve: гонка до LB == UB или до конца всех решателей          |
+ *---------------------------------------------------------------*/
+inline Result solve(const CsrGraph& g, const Options& opt = {})
+{
+    const int n = static_cast<int>(g.size());
+    Shared    sh(n);
+    Result    res;
+    if (n == 0) return res;
+    sh.raiseLower(g.edges() ? 2 : 1);
+
+    std::array<SearchStats, kSolverCount> stats;
+    for (auto& s : stats) s.start = sh.timeline().start;
+
+    std::vector<std::thread> workers;
+    auto launch = [&](int solver, auto body) {
+        workers.emplace_back([&, solver, body]{
+            res.completed[solver] = body(stats[solver]);
+            res.seconds[solver]   = stats[solver].seconds();
+        });
+    };
+    auto offerHeuristic = [&](int solver, const std::vector<int>& col) {
+        sh.offer(colourCount(col), col, solver);
+        return true;
+    };
+    /* точный перебор, не свёрнутый по stop, доказал оптимальность рекорда */
+    auto proved = [&] {
+        if (sh.stopped()) return false;
+        sh.raiseLower(sh.upper());
+        return true;
+    };
+
+    launch(Clique, [&](SearchStats&) {
+        const auto clique = MaxClique::find(g, sh.upper(), MaxClique::kDefaultNodeLimit,
+                                            sh.stopFlag());
+        const bool completed = !sh.stopped();      // до raiseLower: он сам может поднять stop
+        sh.raiseLower(static_cast<int>(clique.size()));
+        return completed;
+    });
+    if (opt.heuristics) {
+        launch(Greedy, [&](SearchStats&) { return offerHeuristic(Greedy, GreedyColoring::color(g)); });
+        launch(DSatur, [&](SearchStats&) { return offerHeuristic(DSatur, DSaturColoring::color(g)); });
+        launch(Heuristic, [&](SearchStats&) {
+            auto col = greedy::Coloring<CsrGraph>(g, 10000, opt.heuristicThreads, sh.lower(),
+                                                  sh.stopFlag()).colors();
+            if (col.empty()) return !sh.stopped();     // χ > maxColor или остановлен
+            for (int& c : col) --c;                    // 1-based → 0-based
+            return offerHeuristic(Heuristic, col);
+        });
+    }
+    if (opt.bnb)
+        launch(BnB, [&](SearchStats& st) {
+            Shared::View view(sh, BnB);
+            DSaturBnB::colorWith(g, view, &st);
+            return proved();
+        });
+    if (opt.mis)
+        launch(Mis, [&](SearchStats& st) {
+            Shared::View view(sh, Mis);
+            BacktrackingColoring::colorWith(g, view, &st);
+            return proved();
+        });
+    if (opt.olemskoy && n <= opt.olemskoyMaxN)
+        launch(Olemskoy, [&](SearchStats& st) {
+            const Graph G(g);
+            OlemskoyColorGraph solver(G);
+            solver.setCancelFlag(sh.stopFlag());
+            solver.setImproveCallback([&](const std::vector<std::vector<int>>& groups) {
+                std::vector<int> col(n, -1);
+                for (std::size_t c = 0; c < groups.size(); ++c)
+                    for (int v : groups[c]) col[v] = static_cast<int>(c);
+                sh.offer(static_cast<int>(groups.size()), col, Olemskoy);
+            });
+            solver.resultColorNodes();
+            const auto start = st.start;
+            st       = solver.stats();
+            st.start = start;
+            return !sh.stopped();
+        });
+
+    for (auto& w : workers) w.join();
+
+    res.colouring  = sh.best();
+    res.chi        = sh.upper();
+    res.lowerBound = sh.lower();
+    res.optimal    = res.lowerBound >= res.chi;
+    res.winner     = sh.winner();
+
+    res.stats = sh.timeline();
+    for (int s : {BnB, Mis, Olemskoy}) {
+        SearchStats work = stats[s];
+        work.improvements.clear();                 // уже в timeline
+        res.stats.merge(work);
+    }
+    res.stats.searchSeconds = res.stats.seconds();
+    return res;
+}
+
+inline Result solve(const DenseMatrix& A, const Options& opt = {})
+{
+    return solve(CsrGraph::fromDense(A), opt);
+}
+
+} // namespace portfolio
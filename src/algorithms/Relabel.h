@@ -0,0 +1,202 @@
+#pragma once
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../CsrGraph.h"
+
+/*---------------------------------------------------------------*
+ |  Перенумерация вершин перед раскраской                         |
+ |                                                                |
+ |  order(g, o)[k] — исходный номер вершины, получающей номер k:  |
+ |    Degree     — по убыванию степени: первые выборы DSATUR     |
+ |                 (наибольшая степень) лежат в первых кэш-линиях |
+ |                 sat_, forbid_ и битовых строк;                 |
+ |    Degeneracy — ядра первыми (обратный smallest-last, Matula–  |
+ |                 Beck, O(n + m));                               |
+ |    Rcm        — обратный Cuthill–McKee: BFS по компонентам от  |
+ |                 псевдопериферийной вершины, соседи — по        |
+ |                 возрастанию степени; уменьшает ширину ленты,   |
+ |                 соседи лежат рядом и в CSR, и в строках.       |
+ |  permute строит перенумерованную копию (списки отсортированы),  |
+ |  colour — решает её и возвращает раскраску в исходных номерах.  |
+ *---------------------------------------------------------------*/
+namespace relabel
+{
+
+enum Order : int
+{
+    Identity,
+    Degree,
+    Degeneracy,
+    Rcm,
+    kOrderCount
+};
+
+inline const char* orderName(int o)
+{
+    static const char* const names[kOrderCount] = {"identity", "degree", "degeneracy", "rcm"};
+    return names[o];
+}
+
+inline Order parseOrder(const std::string& name)
+{
+    for (int o = 0; o < kOrderCount; ++o)
+        if (name == orderName(o)) return static_cast<Order>(o);
+    throw std::runtime_error("Unknown vertex order " + name);
+}
+
+/*-------- по убыванию степени (при равенстве — по номеру) ------*/
+inline std::vector<int> degreeOrder(const CsrGraph& g)
+{
+    std::vector<int> ord(g.size());
+    std::iota(ord.begin(), ord.end(), 0);
+    std::stable_sort(ord.begin(), ord.end(),
+                     [&](int a, int b) { return g.degree(a) > g.degree(b); });
+    return ord;
+}
+
+/*-------- вырожденность: корзины по текущей степени ------------*/
+inline std::vector<int> degeneracyOrder(const CsrGraph& g)
+{
+    const int n = static_cast<int>(g.size());
+    int maxDeg = 0;
+    std::vector<int> deg(n);
+    for (int v = 0; v < n; ++v) maxDeg = std::max(maxDeg, deg[v] = static_cast<int>(g.degree(v)));
+
+    /* корзины: вершины, отсортированные по степени, и начала корзин */
+    std::vector<int> start(maxDeg + 2, 0), vert(n), pos(n);
+    for (int v = 0; v < n; ++v) ++start[deg[v] + 1];
+    for (int d = 0; d <= maxDeg; ++d) start[d + 1] += start[d];
+    {
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int v = 0; v < n; ++v) { pos[v] = fill[deg[v]]++; vert[pos[v]] = v; }
+    }
+
+    /* снимаем вершину наименьшей степени; соседу с большей
+       степенью — шаг в корзину ниже обменом с её первой вершиной */
+    std::vector<char> removed(n, 0);
+    for (int i = 0; i < n; ++i) {
+        const int v = vert[i];
+        removed[v] = 1;
+        for (auto u : g.neighbours(v)) {
+            if (removed[u] || deg[u] <= deg[v]) continue;
+            const int du = deg[u], pu = pos[u], pw = start[du];
+            const int w = vert[pw];
+            if (u != static_cast<CsrGraph::Vertex>(w)) {
+                vert[pu] = w; pos[w] = pu;
+                vert[pw] = static_cast<int>(u); pos[u] = pw;
+            }
+            ++start[du];
+            --deg[u];
+        }
+    }
+    std::reverse(vert.begin(), vert.end());        // снятые последними — первыми
+    return vert;
+}
+
+/*-------- обратный Cuthill–McKee -------------------------------*/
+inline std::vector<int> rcmOrder(const CsrGraph& g)
+{
+    const int n = static_cast<int>(g.size());
+    std::vector<int> ord;
+    ord.reserve(n);
+    std::vector<char> seen(n, 0);
+    std::vector<int>  level(n, -1), nb;
+
+    /* BFS от r по компоненте; возвращает последнюю вершину с
+       наименьшей степенью на последнем уровне */
+    std::vector<int> queue;
+    auto bfs = [&](int r) {
+        queue.assign(1, r);
+        level[r] = 0;
+        for (std::size_t h = 0; h < queue.size(); ++h)
+            for (auto u : g.neighbours(queue[h]))
+                if (level[u] < 0) { level[u] = level[queue[h]] + 1; queue.push_back(static_cast<int>(u)); }
+        int far = queue.back();
+        for (int v : queue)
+            if (level[v] == level[queue.back()] && g.degree(v) < g.degree(far)) far = v;
+        const int depth = level[queue.back()];
+        for (int v : queue) level[v] = -1;
+        return std::make_pair(far, depth);
+    };
+
+    for (int r0 = 0; r0 < n; ++r0) {
+        if (seen[r0]) continue;
+
+        /* псевдопериферийная вершина: пока эксцентриситет растёт */
+        int r = r0;
+        for (int depth = -1;;) {
+            const auto [far, d] = bfs(r);
+            if (d <= depth) break;
+            depth = d;
+            r     = far;
+        }
+
+        /* Cuthill–McKee: соседи по возрастанию степени */
+        const std::size_t first = ord.size();
+        ord.push_back(r);
+        seen[r] = 1;
+        for (std::size_t h = first; h < ord.size(); ++h) {
+            nb.clear();
+            for (auto u : g.neighbours(ord[h]))
+                if (!seen[u]) { seen[u] = 1; nb.push_back(static_cast<int>(u)); }
+            std::stable_sort(nb.begin(), nb.end(),
+                             [&](int a, int b) { return g.degree(a) < g.degree(b); });
+            ord.insert(ord.end(), nb.begin(), nb.end());
+        }
+    }
+    std::reverse(ord.begin(), ord.end());
+    return ord;
+}
+
+inline std::vector<int> order(const CsrGraph& g, Order o)
+{
+    switch (o) {
+        case Degree:     return degreeOrder(g);
+        case Degeneracy: return degeneracyOrder(g);
+        case Rcm:        return rcmOrder(g);
+        default: {
+            std::vector<int> id(g.size());
+            std::iota(id.begin(), id.end(), 0);
+            return id;
+        }
+    }
+}
+
+/*-------- копия с номерами k ← ord[k] -------------------------*/
+inline CsrGraph permute(const CsrGraph& g, const std::vector<int>& ord)
+{
+    const std::size_t n = g.size();
+    std::vector<int> index(n);
+    for (std::size_t k = 0; k < n; ++k) index[ord[k]] = static_cast<int>(k);
+
+    std::vector<CsrGraph::Offset> offsets(n + 1, 0);
+    std::vector<CsrGraph::Vertex> adj;
+    adj.reserve(g.edges() * 2);
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::size_t first = adj.size();
+        for (auto u : g.neighbours(ord[k])) adj.push_back(static_cast<CsrGraph::Vertex>(index[u]));
+        std::sort(adj.begin() + first, adj.end());
+        offsets[k + 1] = adj.size();
+    }
+    return CsrGraph(std::move(offsets), std::move(adj));
+}
+
+/*---------------------------------------------------------------*
+ |  colour: перенумеровать → solve → раскраска в исходных номерах |
+ *---------------------------------------------------------------*/
+template<class Solve>
+std::vector<int> colour(const CsrGraph& g, Solve&& solve, Order o)
+{
+    if (o == Identity) return solve(g);
+    const std::vector<int> ord = order(g, o);
+    const std::vector<int> pc  = solve(permute(g, ord));
+    std::vector<int> col(g.size(), -1);
+    for (std::size_t k = 0; k < ord.size(); ++k) col[ord[k]] = pc[k];
+    return col;
+}
+
+} // namespace relabel
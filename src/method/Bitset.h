@@ -0,0 +1,140 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*---------------------------------------------------------------*
+ |  Упакованные битовые строки: uint64_t-слова, строки матрицы    |
+ |  выровнены по 64 байта (одна кэш-линия).                       |
+ *---------------------------------------------------------------*/
+namespace bits
+{
+using Word = std::uint64_t;
+
+constexpr int         kWordBits     = 64;
+constexpr std::size_t kCacheLine    = 64;
+constexpr int         kWordsPerLine = static_cast<int>(kCacheLine / sizeof(Word));
+
+/* ---------- аллокатор с выравниванием по кэш-линии ---------- */
+template<class T, std::size_t Align = kCacheLine>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    template<class U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() noexcept = default;
+    template<class U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template<class U>
+    bool operator==(const AlignedAllocator<U, Align>&) const noexcept { return true; }
+    template<class U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const noexcept { return false; }
+};
+
+using WordVector = std::vector<Word, AlignedAllocator<Word>>;
+
+/* ---------- размеры ---------- */
+inline int wordsFor(int nbits) { return (nbits + kWordBits - 1) / kWordBits; }
+
+// шаг строки: число слов, округлённое вверх до целой кэш-линии
+inline int strideFor(int nbits)
+{
+    int w = wordsFor(nbits);
+    return (w + kWordsPerLine - 1) / kWordsPerLine * kWordsPerLine;
+}
+
+/* ---------- одно слово ---------- */
+inline int popcount64(Word x)
+{
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(x));
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+inline int ctz64(Word x)                 // x != 0
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+/* ---------- отдельные биты ---------- */
+inline bool test (const Word* row, int i) { return (row[i >> 6] >> (i & 63)) & 1u; }
+inline void set  (Word* row, int i)       { row[i >> 6] |=  (Word{1} << (i & 63)); }
+inline void reset(Word* row, int i)       { row[i >> 6] &= ~(Word{1} << (i & 63)); }
+
+/* ---------- операции над строками длины w слов ---------- */
+inline int popcount(const Word* a, int w)
+{
+    int cnt = 0;
+    for (int k = 0; k < w; ++k) cnt += popcount64(a[k]);
+    return cnt;
+}
+
+// |a ∧ b|
+inline int andCount(const Word* a, const Word* b, int w)
+{
+    int cnt = 0;
+    for (int k = 0; k < w; ++k) cnt += popcount64(a[k] & b[k]);
+    return cnt;
+}
+
+// dst = a ∧ b
+inline void andInto(Word* dst, const Word* a, const Word* b, int w)
+{
+    for (int k = 0; k < w; ++k) dst[k] = a[k] & b[k];
+}
+
+// dst = a ∧ ¬b
+inline void andNotInto(Word* dst, const Word* a, const Word* b, int w)
+{
+    for (int k = 0; k < w; ++k) dst[k] = a[k] & ~b[k];
+}
+
+// a ∧ b ≠ ∅ ?
+inline bool intersects(const Word* a, const Word* b, int w)
+{
+    for (int k = 0; k < w; ++k)
+        if (a[k] & b[k]) return true;
+    return false;
+}
+
+inline bool any(const Word* a, int w)
+{
+    for (int k = 0; k < w; ++k)
+        if (a[k]) return true;
+    return false;
+}
+
+// f(i) для каждого установленного бита, по возрастанию i
+template<class F>
+inline void forEach(const Word* a, int w, F&& f)
+{
+    for (int k = 0; k < w; ++k)
+        for (Word x = a[k]; x; x &= x - 1)
+            f(k * kWordBits + ctz64(x));
+}
+
+} // namespace bits
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <vector>
 #include <algorithm>
 #include <iostream>
@@ -13,57 +14,108 @@ struct GPair {
     std::vector<int> set;
 };
 
+/*  пара (q,r) из Q^{j,s}  */
+using QPair = std::array<int,2>;
+
 inline bool contains(const std::vector<int>& vec, int x)
 {
     return std::find(vec.begin(), vec.end(), x) != vec.end();
 }
 
+/*  (i,j) ∈ Q ?  */
+inline bool pairInQ(const std::vector<QPair>& Q, int i, int j)
+{
+    for (const auto& q : Q)
+        if (q[0] == i && q[1] == j) return true;
+    return false;
+}
+
+/*  рабочие буферы построителя, переиспользуются между вызовами  */
+struct GPairScratch {
+    bits::WordVector omegaRow;           // ω как битовая строка
+    bits::WordVector Ai;                 // ω ∧ H_i ∧ V_i
+    std::vector<int> members;            // члены ω по возрастанию
+};
+
+/*  порядок перебора: |D| по убыванию, затем (i,j)  */
+inline bool gpairLess(const GPair& a, const GPair& b)
+{
+    if (a.set.size() != b.set.size()) return a.set.size() > b.set.size();
+    if (a.i != b.i) return a.i < b.i;
+    return a.j < b.j;
+}
+
 /*  ---------  buildGPairsHV  -------------------------------------------
-    adjency      – 0/1-матрица (std::vector<std::vector<bool>>), диагональ = 0
-    support  – текущий Ω (0-индексированные вершины)
+    g        – граф с упакованными строками H (по строкам) и V (по столбцам)
+    omega    – текущий Ω (0-индексированные вершины)
+    Q        – уже перебранные на этом уровне пары
+
+    D(i,j) = H_i ∧ V_j ∧ H_j ∧ V_i ∧ ω  считается пословно; перебираются
+    только члены ω, ключ сортировки |D(i,j)| даёт popcount.
 
     возвращает отсортированный vector<GPair>
 ------------------------------------------------------------------------ */
-inline std::vector<GPair>
-buildGPairsHV(const Graph& g, const std::vector<int>& omega, const std::vector<std::vector<int>>& Q)
+/*  out переиспользует ёмкость своих GPair::set  */
+inline void
+buildGPairsHV(const Graph& g, const std::vector<int>& omega, const std::vector<QPair>& Q,
+              std::vector<GPair>& out, GPairScratch& scratch)
 {
-    const auto& adj = g.adjacency();
-    const int n = static_cast<int>(adj.size());
+    const int W = g.words();
 
-    /* 2. GPair */
-    std::vector<GPair> out;
-    out.reserve(omega.size()*omega.size()/2);
+    /* 1. ω как битовая строка, ω-члены по возрастанию */
+    auto& omegaRow = scratch.omegaRow;
+    auto& Ai       = scratch.Ai;                    // ω ∧ H_i ∧ V_i
+    auto& members  = scratch.members;
+    if ((int)omegaRow.size() != g.stride()) {
+        omegaRow = g.makeRow();
+        Ai       = g.makeRow();
+    }
+    std::fill(omegaRow.begin(), omegaRow.end(), 0);
+    for (int v : omega) bits::set(omegaRow.data(), v);
 
-    const auto& Hsets = g.Hsets();
-    const auto& Vsets = g.Vsets();
+    members.clear();
+    bits::forEach(omegaRow.data(), W, [&](int v){ members.push_back(v); });
 
-    for (int i = 0; i < n; ++i) {
-        for (int j = i + 1; j < n; ++j) {
-            if (!contains(omega, i) || !contains(omega, j)) continue;
+    /* 2. GPair */
+    size_t cnt = 0;
+    for (size_t a = 0; a < members.size(); ++a) {
+        const int i = members[a];
+        g.andInto(Ai.data(), omegaRow.data(), g.hRow(i));
+        g.andInto(Ai.data(), Ai.data(),       g.vRow(i));
+        if (!bits::test(Ai.data(), i)) continue;         // i ∉ D(i,·)
 
-            std::vector<int> d_qr, d_rq;
-            for (int el : Hsets[i])
-                if (contains(Vsets[j], el) && contains(omega, el)) d_qr.push_back(el);
+        for (size_t b = a + 1; b < members.size(); ++b) {
+            const int j = members[b];
+            /* i, j ∈ D(i,j)  ⇔  j ∈ Ai  и  j ∈ H_j ∧ V_j  (i ∈ H_j ∧ V_j ⇔ j ∈ H_i ∧ V_i) */
+            if (!bits::test(Ai.data(), j) || !bits::test(g.hRow(j), j)) continue;
+            if (pairInQ(Q, i, j)) continue;
 
-            for (int el : Hsets[j])
-                if (contains(Vsets[i], el) && contains(omega, el)) d_rq.push_back(el);
+            const bits::Word* hj = g.hRow(j);
+            const bits::Word* vj = g.vRow(j);
 
-            std::vector<int> Dij;
-            for (int el : d_qr)
-                if (contains(d_rq, el)) Dij.push_back(el);
+            int setSize = 0;
+            for (int k = 0; k < W; ++k) setSize += bits::popcount64(Ai[k] & hj[k] & vj[k]);
 
-            if (!contains(Dij, i) || !contains(Dij, j)) continue;
-            
-            if (std::find(Q.begin(), Q.end(), std::vector<int> {i,j}) != Q.end()) continue;
-            out.push_back({i, j, std::move(Dij)});
+            if (cnt == out.size()) out.emplace_back();
+            GPair& gp = out[cnt++];
+            gp.i = i;
+            gp.j = j;
+            gp.set.clear();
+            gp.set.reserve(setSize);
+            for (int k = 0; k < W; ++k)
+                for (bits::Word x = Ai[k] & hj[k] & vj[k]; x; x &= x - 1)
+                    gp.set.push_back(k * bits::kWordBits + bits::ctz64(x));
         }
     }
-    std::sort(out.begin(), out.end(),
-        [](const GPair& a,const GPair& b){
-            if (a.set.size() != b.set.size()) return a.set.size() > b.set.size();
-            if (a.i != b.i) return a.i < b.i;
-            return a.j < b.j;
-        });
+    out.resize(cnt);
+    std::sort(out.begin(), out.end(), gpairLess);
+}
 
+inline std::vector<GPair>
+buildGPairsHV(const Graph& g, const std::vector<int>& omega, const std::vector<QPair>& Q)
+{
+    std::vector<GPair> out;
+    GPairScratch scratch;
+    buildGPairsHV(g, omega, Q, out, scratch);
     return out;
 }
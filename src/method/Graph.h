@@ -5,6 +5,8 @@
 #include <iostream>
 #include <vector>
 
+#include "../CsrGraph.h"
+#include "Bitset.h"
 #include "Utils.h"
 
 using DenseMatrix = Eigen::Matrix<int,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>;
@@ -12,45 +14,77 @@ using DenseMatrix = Eigen::Matrix<int,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMa
 class Graph {
 private:
     int n;
-    std::vector<std::vector<bool>> adj;
-    std::vector<std::vector<int>>  Hsets_, Vsets_;
-public:
-    // Construct Graph from a symmetric [0-1] matrix (Eigen)
-    Graph(const DenseMatrix& matrix) : n(matrix.rows()),
-    adj(n, std::vector<bool>(n)),
-    Hsets_(n),        
-    Vsets_(n) {
-        n = matrix.rows();
-        adj.assign(n, std::vector<bool>(n));
+    int words_  = 0;                 // значимых слов в строке
+    int stride_ = 0;                 // шаг строки (кратен кэш-линии)
 
+    // Row-major word arrays, every row starts on a 64-byte boundary:
+    //   adj_ : row i = { j : matrix(i,j) != 0 }
+    //   H_   : row i = { j : matrix(i,j) == 0 }   (non-neighbours by row)
+    //   V_   : row j = { i : matrix(i,j) == 0 }   (non-neighbours by column)
+    bits::WordVector adj_, H_, V_;
+public:
+    // Construct Graph from a CSR graph (symmetric, no self-loops)
+    explicit Graph(const CsrGraph& g) : n(static_cast<int>(g.size())),
+    words_(bits::wordsFor(n)),
+    stride_(bits::strideFor(n)),
+    adj_(static_cast<size_t>(n) * stride_, 0),
+    H_  (static_cast<size_t>(n) * stride_, 0),
+    V_  (static_cast<size_t>(n) * stride_, 0) {
         for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < n; ++j) {
-                bool edge = (matrix(i, j) != 0);
-                // Treat nonzero as adjacent (assuming 1 for edges, 0 for no edge)
-                // Ensure diagonal is treated as no self-loop (0) for safety
-                adj[i][j] = edge;
-
-                if (!edge) {                 
-                    Hsets_[i].push_back(j);
-                    Vsets_[j].push_back(i);
-                }
+            for (int j = 0; j < n; ++j) bits::set(row(H_, i), j);
+            for (auto j : g.neighbours(i)) {
+                bits::set(row(adj_, i), j);
+                bits::reset(row(H_, i), j);
             }
         }
+        // symmetric graph: non-neighbours by column == by row
+        V_ = H_;
     }
 
+    // Construct Graph from a symmetric [0-1] matrix (Eigen)
+    Graph(const DenseMatrix& matrix) : Graph(CsrGraph::fromDense(matrix)) {}
+
     // Number of vertices
     int size() const {
         return n;
     }
 
+    // Number of meaningful words per row (padding words are always zero)
+    int words() const {
+        return words_;
+    }
+
     // Check if two vertices are adjacent (matrix entry == 1)
     bool areAdjacent(int i, int j) const {
-        return adj[i][j];
+        return bits::test(adjRow(i), j);
     }
 
-    const std::vector<std::vector<bool>>& adjacency() const { return adj; }
-    const std::vector<std::vector<int>>& Hsets() const { return Hsets_; }
-    const std::vector<std::vector<int>>& Vsets() const { return Vsets_; }
+    int degree(int i) const {
+        return bits::popcount(adjRow(i), words_);
+    }
+
+    // Packed rows (words() words each, 64-byte aligned)
+    const bits::Word* adjRow(int i) const { return adj_.data() + static_cast<size_t>(i) * stride_; }
+    const bits::Word* hRow  (int i) const { return H_.data()   + static_cast<size_t>(i) * stride_; }
+    const bits::Word* vRow  (int j) const { return V_.data()   + static_cast<size_t>(j) * stride_; }
+
+    // Row primitives over words() words
+    int  andCount  (const bits::Word* a, const bits::Word* b) const { return bits::andCount(a, b, words_); }
+    void andInto   (bits::Word* dst, const bits::Word* a, const bits::Word* b) const { bits::andInto(dst, a, b, words_); }
+    void andNotInto(bits::Word* dst, const bits::Word* a, const bits::Word* b) const { bits::andNotInto(dst, a, b, words_); }
+    bool intersects(const bits::Word* a, const bits::Word* b) const { return bits::intersects(a, b, words_); }
+    int  popcount  (const bits::Word* a) const { return bits::popcount(a, words_); }
+
+    // Row stride in words (multiple of a cache line)
+    int stride() const {
+        return stride_;
+    }
+
+    // Fresh zeroed row buffer of the same layout
+    bits::WordVector makeRow() const { return bits::WordVector(stride_, 0); }
+
+private:
+    bits::Word* row(bits::WordVector& rows, int i) { return rows.data() + static_cast<size_t>(i) * stride_; }
 };
 
 #endif // OLEMSKOY_GRAPH_H
@@ -1,168 +1,278 @@
 #include "OlemskoyColorGraph.h"
 #include "GPair.h"
+#include "../WorkStealingPool.h"
 
 #include <algorithm>
 #include <cassert>
-#include <fstream>
 #include <iostream>
+#include <memory>
 #include <numeric>
 
 /*---------------------------------------------------------------*
- |  Единый поток-лог →  olemskoy_steps.txt                       |
+ |  Трасса рабочего (см. OlemskoyTrace.h); при уровне 0           |
+ |  вызовы вместе с аргументами вырезаются препроцессором.        |
  *---------------------------------------------------------------*/
-static std::ofstream LOG("olemskoy_steps.txt");
+#define TRACE(...) OLEMSKOY_TRACE(*st.trace, __VA_ARGS__)
 
 /* ---------- «пустые» статические контейнеры ---------- */
 static const std::vector<int>              kEmptyIntVec;
-static const std::vector<std::vector<int>> kEmptyInt2d;
+static const std::vector<QPair>            kEmptyQPairVec;
 static const std::vector<GPair>            kEmptyGPairVec;
 
+/* v ← min(v, x); true, если значение уменьшилось */
+static bool atomicMin(std::atomic<int>& v, int x)
+{
+    int cur = v.load(std::memory_order_relaxed);
+    while (x < cur)
+        if (v.compare_exchange_weak(cur, x, std::memory_order_relaxed)) return true;
+    return false;
+}
+
 
 /*================================================================*/
-/*                    OlemskoyColorGraph                          */
+/*                        SearchState                             */
 /*================================================================*/
-OlemskoyColorGraph::OlemskoyColorGraph(const Graph& matrix) : g(matrix)
+void SearchState::reset(int n)
 {
-    n                        = g.size();
-    bestColorCount           = n;       // стартовая оценка χ
-    bestColorBottomLineColor = n;
     used.assign(n, false);
-    LOG << "Graph n = " << n << '\n';
+    currentPartition.clear();
+    r_j.assign(n + 1, -1);
+    mark.assign(n, 0);
+    stamp = 0;
+    uncoloured = n;
+
+    /* каждый уровень снимает ≥ 2 вершины, каждый блок — ≥ 1 уровень:
+       одновременно живы не более n + 1 кадров                      */
+    frames.clear();
+    frames.resize(n + 2);
+    for (auto& f : frames) f.omega.reserve(n);
+    blockBase.assign(n + 2, 0);
+    path.assign(n + 2, 0);
 }
 
-/*---------------------------------------------------------------*
- |                                                                |
- *---------------------------------------------------------------*/
-std::vector<std::vector<int>> OlemskoyColorGraph::resultColorNodes()
+SearchState SearchState::snapshot(int j, int s) const
 {
-    bestPartition.clear();
-    currentPartition.clear();
-    firstBlockSeen.clear();
-
-    omega_.clear(); Q_.clear(); F_.clear(); G_.clear();
-
-    LOG << "--- Начало алгоритма --- \n";
-    searchBlocks(0);
-    LOG << "--- Алгоритм закончен, минимальное количество цветов: "
-        << bestColorCount << " ---\n";
-
-    return bestPartition;
+    SearchState copy;
+    copy.used             = used;
+    copy.currentPartition = currentPartition;
+    copy.r_j              = r_j;
+    copy.blockBase        = blockBase;
+    copy.mark.assign(mark.size(), 0);
+    copy.uncoloured       = uncoloured;
+    copy.path             = path;
+    copy.trace            = trace;
+    copy.stats            = stats;
+    copy.best             = best;
+    copy.seenVersion      = seenVersion;
+    copy.recordChi        = recordChi;
+    copy.recordPath       = recordPath;
+
+    const size_t top = static_cast<size_t>(blockBase[j] + s);
+    for (size_t k = 0; k <= top; ++k) {
+        LevelFrame f;
+        f.omega = frames[k].omega;
+        f.Q     = frames[k].Q;
+        f.F     = frames[k].F;
+        f.live  = frames[k].live;            // G нужен только пока уровень перебирается
+        copy.frames.push_back(std::move(f));
+    }
+    return copy;
 }
 
-/*---------------------------------------------------------------*
- |                ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ                        |
- *---------------------------------------------------------------*/
-void OlemskoyColorGraph::setLevelData(int j, int s,
-                                      const std::vector<int>&   omega,
-                                      const std::vector<GPair>& G)
+LevelFrame& SearchState::frame(int j, int s)
 {
-    Key key{j,s};
-    omega_[key] = omega;
-    G_[key] = G;
+    const size_t idx = static_cast<size_t>(blockBase[j] + s);
+    if (idx >= frames.size()) frames.resize(idx + 1);     // не инвалидирует ссылки
+    return frames[idx];
+}
 
-    Q_[key] = kEmptyInt2d;
-    F_[key] = kEmptyIntVec;
+const LevelFrame& SearchState::frame(int j, int s) const
+{
+    return frames[static_cast<size_t>(blockBase[j] + s)];
 }
 
-void OlemskoyColorGraph::setOmega(int j,int s, const std::vector<int>& omega) { 
-    omega_[{j,s}] = omega;
- }
+void SearchState::setLevelData(int j, int s)
+{
+    LevelFrame& f = frame(j, s);
+    f.live = true;
+    f.Q.clear();
+    f.F.clear();
+}
 
-void OlemskoyColorGraph::addQ(int j,int s,int q, int r) { 
-    Q_[{j,s}].push_back({q,r});
+void SearchState::addQ(int j,int s,int q, int r) { 
+    frame(j, s).Q.push_back({q,r});
  }
  
-void OlemskoyColorGraph::addF(int j,int s,int q, int r) { 
-    F_[{j,s}].push_back(q);
-    F_[{j,s}].push_back(r);
+void SearchState::addF(int j,int s,int q, int r) { 
+    frame(j, s).F.push_back(q);
+    frame(j, s).F.push_back(r);
  }
 
- void OlemskoyColorGraph::addF(int j,int s,int v) { 
-    F_[{j,s}].push_back(v);
+ void SearchState::addF(int j,int s,int v) { 
+    frame(j, s).F.push_back(v);
  }
 
-void OlemskoyColorGraph::eraseLevel(int j,int s)
+void SearchState::eraseLevel(int j,int s)
 {
-    Key k{j,s};
-    omega_.erase(k);
-    Q_.erase(k);
-    F_.erase(k);
-    G_.erase(k);
+    LevelFrame& f = frame(j, s);
+    f.live = false;
+    f.Q.clear();
+    f.F.clear();
 }
 
 /* ---------- безопасные геттеры ---------- */
 const std::vector<int>&
-OlemskoyColorGraph::getOmega(int j,int s) const
+SearchState::getOmega(int j,int s) const
 {
-    auto it = omega_.find({j,s});
-    return (it == omega_.end()) ? kEmptyIntVec : it->second;
+    return frame(j, s).omega;
 }
 
-const std::vector<std::vector<int>>&
-OlemskoyColorGraph::getQ(int j,int s) const
+const std::vector<QPair>&
+SearchState::getQ(int j,int s) const
 {
-    auto it = Q_.find({j,s});
-    return (it == Q_.end()) ? kEmptyInt2d : it->second;
+    const LevelFrame& f = frame(j, s);
+    return f.live ? f.Q : kEmptyQPairVec;
 }
 
 const std::vector<int>&
-OlemskoyColorGraph::getF(int j,int s) const
+SearchState::getF(int j,int s) const
 {
-    auto it = F_.find({j,s});
-    return (it == F_.end()) ? kEmptyIntVec : it->second;
+    return frame(j, s).F;
 }
 
 const std::vector<GPair>&
-OlemskoyColorGraph::getG(int j,int s) const
+SearchState::getG(int j,int s) const
 {
-    auto it = G_.find({j,s});
-    return (it == G_.end()) ? kEmptyGPairVec : it->second;
+    const LevelFrame& f = frame(j, s);
+    return f.live ? f.G : kEmptyGPairVec;
 }
 
-const std::vector<GPair>&
-OlemskoyColorGraph::getZ(int j,int s) const
+
+/*================================================================*/
+/*                    OlemskoyColorGraph                          */
+/*================================================================*/
+OlemskoyColorGraph::OlemskoyColorGraph(const Graph& matrix) : g(matrix)
+{
+    n                        = g.size();
+    bestColorCount           = n;       // стартовая оценка χ
+    bestColorBottomLineColor = n;
+    OLEMSKOY_TRACE(trace_, GraphSize, n);
+}
+
+void OlemskoyColorGraph::prepare()
 {
-    auto it = Z_.find({j,s});
-    return (it == Z_.end()) ? kEmptyGPairVec : it->second;
+    bestPartition.clear();
+    bestColorCount           = n;
+    bestColorBottomLineColor = n;
+    bestPath_.clear();
+    recordVersion_.fetch_add(1, std::memory_order_relaxed);  // кэш прошлого поиска устарел
+    firstBlockSeen.clear();
+    state_.reset(n);
+    state_.trace = &trace_;
+    stats_       = SearchStats{};
+    state_.stats = &stats_;
+    state_.best  = n;
 }
 
 /*---------------------------------------------------------------*
- |  Ψ^{j,s} = J^{j} \ ⋃_{μ=1}^{s-1} Q^{j,μ}                      |
+ |                                                                |
  *---------------------------------------------------------------*/
-std::vector<int>
-OlemskoyColorGraph::computePsi(int j, int s,
-                               const std::vector<int>& J) const
+std::vector<std::vector<int>> OlemskoyColorGraph::resultColorNodes()
 {
-    /* 1. skip = ⋃_{μ=1}^{s-1} Q^{j,μ} */
-    std::unordered_set<int> skip;
+    prepare();
+    SearchState& st = state_;
+
+    TRACE(Start);
+    searchBlocks(st, 0);
+    TRACE(Finish, bestColorCount.load());
+    stats_.searchSeconds = stats_.seconds();
 
+    return bestPartition;
+}
+
+/*---------------------------------------------------------------*
+ |  Параллельный поиск: корень — задача пула; пока есть           |
+ |  простаивающие рабочие, узел любого уровня отдаёт им пары       |
+ |  (spawnPair), рекорд общий (bound/publish).                     |
+ *---------------------------------------------------------------*/
+std::vector<std::vector<int>>
+OlemskoyColorGraph::resultColorNodesParallel(unsigned threads)
+{
+    prepare();
+    SearchState& st = state_;
+
+    WorkStealingPool pool(threads);
+    workerTraces_.assign(pool.size(), otrace::Recorder{});
+    workerStats_.assign(pool.size(), SearchStats{});
+    for (auto& ws : workerStats_) ws.start = stats_.start;
+    pool_ = &pool;
+
+    TRACE(Start);
+    pool.submit([this] {
+        state_.trace = &workerTraces_[pool_->workerIndex()];
+        state_.stats = &workerStats_[pool_->workerIndex()];
+        searchBlocks(state_, 0);
+    });
+    try {
+        pool.wait();
+    } catch (...) {
+        pool_ = nullptr;
+        st.trace = &trace_;
+        st.stats = &stats_;
+        throw;
+    }
+    pool_ = nullptr;
+    st.trace = &trace_;
+    st.stats = &stats_;
+
+    for (const auto& wt : workerTraces_) trace_.mergeCounters(wt);
+    workerTraces_.clear();
+    for (const auto& ws : workerStats_) stats_.merge(ws);
+    workerStats_.clear();
+    stats_.searchSeconds = stats_.seconds();
+    TRACE(Finish, bestColorCount.load());
+
+    return bestPartition;
+}
+
+/*---------------------------------------------------------------*
+ |                ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ                        |
+ *---------------------------------------------------------------*/
+/*---------------------------------------------------------------*
+ |  Ψ^{j,s} = J^{j} \ ⋃_{μ=1}^{s-1} Q^{j,μ}                      |
+ *---------------------------------------------------------------*/
+void OlemskoyColorGraph::computePsi(SearchState& st, int j, int s,
+                                    const std::vector<int>& J,
+                                    std::vector<int>& psi) const
+{
+    /* 1. skip = ⋃_{μ=1}^{s-1} Q^{j,μ}  — штампы вместо хеш-множества */
+    const int stamp = ++st.stamp;
     for (int mu = 1; mu < s; ++mu) {                 // μ = 1 … s-1
-        const auto& qLevel = getQ(j, mu);            // ← геттер, может быть пуст
+        const auto& qLevel = st.getQ(j, mu);         // ← геттер, может быть пуст
         for (const auto& qpair : qLevel)             // каждая пара <α1,α2>
-            for (int v : qpair) skip.insert(v);      // обе вершины → skip
+            for (int v : qpair) st.mark[v] = stamp;  // обе вершины → skip
     }
 
     /* 2. Ψ = J \ skip */
-    std::vector<int> psi;
-    psi.reserve(J.size());
+    psi.clear();
     for (int v : J)
-        if (!skip.count(v)) psi.push_back(v);
-
-    return psi;                                      // Ψ^{j,s}
+        if (st.mark[v] != stamp) psi.push_back(v);
 }
 
 /*---------------------------------------------------------------*
  |  Ψ\Z-прореживание                                             |
  *---------------------------------------------------------------*/
-std::vector<int>
-OlemskoyColorGraph::pruneOmega(int j, int s,
-                               const std::vector<int>& J) const
+void OlemskoyColorGraph::pruneOmega(SearchState& st, int j, int s,
+                                    const std::vector<int>& J,
+                                    std::vector<int>& pruned) const
 {
-    auto psi = computePsi(j, s, J);          // Ψ^{j,s}
+    auto& psi = st.psi;
+    computePsi(st, j, s, J, psi);            // Ψ^{j,s}
 
     /* Z^{j,s} формируем из сохранённых G^{j,s} */
-    const auto& gPairs = getG(j, s);         // может быть пуст
-    std::vector<int> Z;
+    const auto& gPairs = st.getG(j, s);      // может быть пуст
+    auto& Z = st.Z;
+    Z.clear();
     for (const auto& gp : gPairs)
         if (gp.set == psi) {                 // D_{α}^{j,s} == Ψ ?
             Z.push_back(gp.i);
@@ -170,115 +280,120 @@ OlemskoyColorGraph::pruneOmega(int j, int s,
         }
 
     /* Ψ \ Z */
-    std::vector<int> pruned;
+    pruned.clear();
     for (int v : psi)
         if (std::find(Z.begin(), Z.end(), v) == Z.end())
             pruned.push_back(v);
+    if (pruned.size() < psi.size()) st.stats->prune(SearchStats::PsiZ);
 
-    LOG << "Ψ (" << j << ", " << s << ")" <<psi<< '\n';
-    LOG << "Z (" << j << ", " << s << ")" <<Z<< '\n';
-    LOG << "Ψ\\Z (" << j << ", " << s << ")" <<pruned<< '\n';
-    return pruned;
+    TRACE(Psi,       j, s, psi);
+    TRACE(Z,         j, s, Z);
+    TRACE(PsiMinusZ, j, s, pruned);
 }
 
 /*---------------------------------------------------------------*
  |                 ОСНОВНАЯ РЕКУРСИЯ                             |
  *---------------------------------------------------------------*/
-void OlemskoyColorGraph::searchBlocks(int currentBlockIndex)
+void OlemskoyColorGraph::searchBlocks(SearchState& st, int currentBlockIndex)
 {
     bool allColored = true;
     for (int v = 0; v < n; ++v)
-        if (!used[v]) { allColored = false; break; }
+        if (!st.used[v]) { allColored = false; break; }
 
     if (allColored) {
         int blocksUsed = currentBlockIndex;
-        LOG << "Все вершины покрашены в " << blocksUsed << " блоков/блока\n";
-
-        if (blocksUsed < bestColorCount) {
-            bestColorCount = blocksUsed;
-            bestPartition  = currentPartition;
-            LOG << "Найдено меньшее хроматическое число! Оно равно "
-                << bestColorCount << " \n";
-        }
-
+        TRACE(AllColored, blocksUsed);
+
+        /* лист сам проходит проверку B при рекорде χ + 1, иначе какой
+           из равных листов станет рекордом, зависело бы от того, кого
+           B успела отсечь                                               */
+        const int depth = st.blockBase[currentBlockIndex];
+        const int first = blocksUsed > 0 ? (int)st.currentPartition[0].size() : 0;
+        if (blocksUsed < bound(st, depth) && first > n / (blocksUsed + 1))
+            publish(st, blocksUsed, depth);
         return;
     }
 
-    /* Ω — множество ещё не закрашенных */
-    std::vector<int> omega;
+    /* Ω — множество ещё не закрашенных, сразу в кадр (j,0) */
+    auto& omega = st.frame(currentBlockIndex, 0).omega;
+    omega.clear();
     for (int v = 0; v < n; ++v)
-        if (!used[v]) omega.push_back(v);
+        if (!st.used[v]) omega.push_back(v);
 
     /* старт построения блока */
     std::vector<int> currentBlock;
-    std::vector<int> r_j(n, -1);
+    st.r_j[currentBlockIndex] = -1;
 
-    buildBlock(currentBlockIndex, 0, currentBlock, omega, r_j);
+    buildBlock(st, currentBlockIndex, 0, currentBlock);
 }
 
 /*───────────────────────────────────────────────────────────────*/
-void OlemskoyColorGraph::buildBlock(int blockIndex, int level,
-                                    std::vector<int>&       currentBlock,
-                                    const std::vector<int>& omega,
-                                std::vector<int>&       r_j
-                                )
+void OlemskoyColorGraph::buildBlock(SearchState& st, int blockIndex, int level,
+                                    std::vector<int>& currentBlock)
 {
-    r_j[blockIndex] = level;
-    setOmega(blockIndex, level, omega);
+    st.r_j[blockIndex] = level;
+    if (cancelled()) return;
+    st.stats->node(st.blockBase[blockIndex] + level);
+    LevelFrame&             cur   = st.frame(blockIndex, level);
+    const std::vector<int>& omega = cur.omega;
     /*-------------------- БАЗА: ω пусто ------------------------*/
     if (omega.empty()) {
-        LOG << "Опорное множество(" << blockIndex << ", " << level
-        << "): " << omega << "пусто \n";
-        LOG << "Блок(" << blockIndex << ", " << level << "): "
-            << currentBlock << "\n";
+        TRACE(OmegaEmpty, blockIndex, level, omega);
+        TRACE(Block,      blockIndex, level, currentBlock);
 
         /* Ψ\Z-прореживание перед переходом к следующему блоку */
         if (level > 0)
         {
-            std::vector<int> singles = pruneOmega(blockIndex, level, currentBlock);
+            cur.F.clear();
+            pruneOmega(st, blockIndex, level, currentBlock, st.singles);
             
-            for (int v : singles) {
-                addF(blockIndex, level, v);                  // F^{j,s-1} ← … ∪ {v}
-                LOG << "Добавлена единичная вершина: " << v << '\n';
+            for (int v : st.singles) {
+                st.addF(blockIndex, level, v);               // F^{j,s-1} ← … ∪ {v}
+                TRACE(Single, v);
             }
         
-            LOG << "Q("<< blockIndex << ", " << level << ") = "
-                << getQ(blockIndex, level) << '\n';
-            LOG << "F("<< blockIndex << ", " << level << ") = "
-                << getF(blockIndex, level) << '\n';
+            TRACE(QState, blockIndex, level, st.getQ(blockIndex, level));
+            TRACE(FState, blockIndex, level, st.getF(blockIndex, level));
         }
-        currentPartition.push_back(currentBlock);
-        LOG << "Текущий набор блоков: " << currentPartition << "\n";
+        st.currentPartition.push_back(currentBlock);
+        TRACE(Partition, st.currentPartition);
 
-        searchBlocks(blockIndex + 1);
+        /* кадры следующего блока начинаются сразу за этим */
+        st.path[st.blockBase[blockIndex] + level] = 0;
+        st.blockBase[blockIndex + 1] = st.blockBase[blockIndex] + level + 1;
+        searchBlocks(st, blockIndex + 1);
 
-        currentPartition.pop_back();
+        st.currentPartition.pop_back();
         return;
     }
 
     /*-------------------- ОБЫЧНЫЙ СЛУЧАЙ -----------------------*/
-    LOG << "Опорное множество(" << blockIndex << ", " << level
-        << "): " << omega << "\n";
-
-    LOG << "Q: (" << blockIndex << ", " << level
-    << "): " << getQ(blockIndex, level) << '\n';
-
-    auto gPairs = buildGPairsHV(g, omega, getQ(blockIndex, level));
-    LOG << "Возможные варианты продолжений G\\Q " << gPairs << '\n';
-
-    LOG << "Номер текущего блока: " << blockIndex
-        << ", уровень: " << level << '\n';
-
+    TRACE(Omega,  blockIndex, level, omega);
+    TRACE(QLevel, blockIndex, level, st.getQ(blockIndex, level));
+
+    /* G строится прямо в кадр; до setLevelData он не виден геттерам.
+       Полный перебор пар ω и на s > 0: ω^{j,s} после снятия N(i) ∪ N(j)
+       много меньше ω^{j,s-1}, и пар в нём меньше, чем в G^{j,s-1},
+       так что фильтр G родителя обходится дороже построения заново.   */
+    auto& gPairs = cur.G;
+    const bool timed   = st.stats->sampleGPair();
+    const auto gpStart = timed ? SearchStats::Clock::now() : SearchStats::Clock::time_point{};
+    buildGPairsHV(g, omega, st.getQ(blockIndex, level), gPairs, st.gpScratch);
+    if (timed) st.stats->gpairTimedBuild(SearchStats::since(gpStart));
+    TRACE(GPairs, gPairs);
+    TRACE(BlockLevel, blockIndex, level);
+
+    const int depth = st.blockBase[blockIndex] + level;
+    const int best  = bound(st, depth);
     /*-------- проверки A/B/C                            --------*/
     if (blockIndex != 0 && !gPairs.empty()) {                  // A
         int ro = std::max<int>(1, gPairs[0].set.size());
-        LOG << "Проверка A [" << blockIndex << "] "
-            << blockIndex << " + " << (int)omega.size() / ro
-            << " < " << bestColorCount << "\n";
-        if (blockIndex + (int)omega.size() / ro > bestColorCount) {
-            LOG << "проверка A провалена\n";
+        TRACE(CheckA, blockIndex, (int)omega.size() / ro, best);
+        if (blockIndex + (int)omega.size() / ro > best) {
+            TRACE(CheckAFail);
+            st.stats->prune(SearchStats::CheckA);
             blockIndex--;
-            level= r_j[blockIndex];
+            level= st.r_j[blockIndex];
             return;
         }
     }
@@ -286,64 +401,139 @@ void OlemskoyColorGraph::buildBlock(int blockIndex, int level,
     if (blockIndex == 0 && !gPairs.empty()) {                  // B
         int ro         = std::max<int>(1, gPairs[0].set.size());
         int potential  = 2 * level + ro;
-        int flooredDiv = n / bestColorCount;
-        LOG << "Проверка В [" << blockIndex << "] "
-            << 2 * level << " + " << ro << " > "
-            << flooredDiv << "\n";
+        int flooredDiv = n / best;
+        TRACE(CheckB, blockIndex, 2 * level, ro, flooredDiv);
         if (potential > flooredDiv) {
-            LOG << "проверка В успешна\n";
-            if (bestColorBottomLineColor > (n + ro - 1) / ro) {
-                bestColorBottomLineColor = (n + ro - 1) / ro;
-                LOG << "Получена нижняя оценка χ: "
-                    << bestColorBottomLineColor << "\n";
+            TRACE(CheckBPass);
+            if (atomicMin(bestColorBottomLineColor, (n + ro - 1) / ro)) {
+                TRACE(LowerBound, (n + ro - 1) / ro);
             }
         } else {
-            LOG << "проверка В провалена\n";
+            TRACE(CheckBFail);
+            st.stats->prune(SearchStats::CheckB);
             return;
         }
     }
 
-    if (blockIndex + 2 == bestColorCount && !gPairs.empty()) { // C
-        int ro = std::max<int>(1, gPairs[0].set.size());
-        if (2 * level + ro == (int)omega.size()) {
-            LOG << "проверка C провалена\n";
+    /* C: χ листа не меньше j + 1, а j + 1 — только если блок j
+       вберёт всё незакрашенное: вне ω ничего не осталось и ω целиком
+       независимо (|ω| ≤ ro); иначе χ ≥ j + 2                        */
+    if (blockIndex + 2 >= best && !gPairs.empty()) {           // C
+        int  ro   = std::max<int>(1, gPairs[0].set.size());
+        bool rest = st.uncoloured != (int)omega.size();        // есть вне ω и блока
+        if (blockIndex + 1 >= best || rest || (int)omega.size() > ro) {
+            TRACE(CheckCFail);
+            st.stats->prune(SearchStats::CheckC);
             return;
         }
     }
 
     /*---------------- сохраняем данные уровня ------------------*/
-    setLevelData(blockIndex, level, omega, gPairs);
+    st.setLevelData(blockIndex, level);
 
     /*---------------- перебираем пары (α) ----------------------*/
-    for (const auto& pr : gPairs) {
-        addQ(blockIndex, level, pr.i, pr.j);
-
-        LOG << "Q: (" << blockIndex << ", " << level
-        << "): " << getQ(blockIndex, level) << '\n';
-
-        used[pr.i] = used[pr.j] = true;
-        currentBlock.push_back(pr.i);
-        currentBlock.push_back(pr.j);
-        std::sort(currentBlock.begin(), currentBlock.end());
-
-        /* ω  ←  ω  \ { i,j }  \ N(i)  \ N(j) */
-        std::vector<int> updatedOmega;
-        for (int node : omega)
-            if (node != pr.i && node != pr.j &&
-                !g.areAdjacent(pr.i,node) && !g.areAdjacent(pr.j,node))
-                updatedOmega.push_back(node);
-
-        buildBlock(blockIndex, level + 1, currentBlock, updatedOmega, r_j);
-
-        currentBlock.erase(std::remove(currentBlock.begin(),
-                                       currentBlock.end(), pr.i),
-                           currentBlock.end());
-        currentBlock.erase(std::remove(currentBlock.begin(),
-                                       currentBlock.end(), pr.j),
-                           currentBlock.end());
-        used[pr.i] = used[pr.j] = false;
+    for (size_t k = 0; k < gPairs.size(); ++k) {
+        const auto& pr = gPairs[k];
+        st.addQ(blockIndex, level, pr.i, pr.j);
+        st.path[depth] = static_cast<int>(k);
+
+        TRACE(QLevel, blockIndex, level, st.getQ(blockIndex, level));
+
+        /* простаивающему рабочему — пару, последнюю оставляем себе */
+        if (pool_ && k + 1 < gPairs.size() && pool_->hungry())
+            spawnPair(st, blockIndex, level, pr, currentBlock);
+        else
+            tryPair(st, blockIndex, level, pr, currentBlock);
     }
 
     /*--- очистка данных уровня (как popLevel) ---*/
-    eraseLevel(blockIndex, level);
+    st.eraseLevel(blockIndex, level);
+}
+
+/*───────────────────────────────────────────────────────────────*/
+/*  добавить пару (i,j) в текущий блок и спуститься на уровень s+1 */
+void OlemskoyColorGraph::tryPair(SearchState& st, int blockIndex, int level,
+                                 const GPair& pr, std::vector<int>& currentBlock)
+{
+    const std::vector<int>& omega = st.frame(blockIndex, level).omega;
+
+    st.used[pr.i] = st.used[pr.j] = true;
+    st.uncoloured -= 2;
+    currentBlock.push_back(pr.i);
+    currentBlock.push_back(pr.j);
+    std::sort(currentBlock.begin(), currentBlock.end());
+
+    /* ω  ←  ω  \ { i,j }  \ N(i)  \ N(j)   — прямо в кадр (j,s+1) */
+    auto& updatedOmega = st.frame(blockIndex, level + 1).omega;
+    updatedOmega.clear();
+    for (int node : omega)
+        if (node != pr.i && node != pr.j &&
+            !g.areAdjacent(pr.i,node) && !g.areAdjacent(pr.j,node))
+            updatedOmega.push_back(node);
+
+    buildBlock(st, blockIndex, level + 1, currentBlock);
+
+    currentBlock.erase(std::remove(currentBlock.begin(),
+                                   currentBlock.end(), pr.i),
+                       currentBlock.end());
+    currentBlock.erase(std::remove(currentBlock.begin(),
+                                   currentBlock.end(), pr.j),
+                       currentBlock.end());
+    st.used[pr.i] = st.used[pr.j] = false;
+    st.uncoloured += 2;
+}
+
+/*───────────────────────────────────────────────────────────────*/
+/*  отдать пару в пул: задача получает копию пути до (j,s), где   */
+/*  Q^{j,s} и path уже содержат эту пару, и выполняет tryPair     */
+void OlemskoyColorGraph::spawnPair(const SearchState& st, int blockIndex, int level,
+                                   const GPair& pr, const std::vector<int>& currentBlock)
+{
+    auto task = std::make_shared<SearchState>(st.snapshot(blockIndex, level));
+    pool_->submit([this, task, blockIndex, level, pair = pr, block = currentBlock]() mutable {
+        task->trace = &workerTraces_[pool_->workerIndex()];
+        task->stats = &workerStats_[pool_->workerIndex()];
+        tryPair(*task, blockIndex, level, pair, block);
+    });
+}
+
+/*───────────────────────────────────────────────────────────────*/
+/*  рекорд обхода: свой — сразу, общий — если ключ меньше         */
+void OlemskoyColorGraph::publish(SearchState& st, int blocksUsed, int depth)
+{
+    st.best = blocksUsed;
+    st.stats->improved(blocksUsed);
+    TRACE(NewBest, blocksUsed);
+
+    const auto leaf = st.path.begin() + depth;
+    std::lock_guard<std::mutex> lk(bestMutex_);
+    const int chi = bestColorCount.load(std::memory_order_relaxed);
+    if (blocksUsed > chi) return;                // записи задач приходят не по порядку
+    if (blocksUsed == chi && !bestPartition.empty() &&
+        !std::lexicographical_compare(st.path.begin(), leaf, bestPath_.begin(), bestPath_.end()))
+        return;
+    bestPath_.assign(st.path.begin(), leaf);
+    bestPartition  = st.currentPartition;
+    bestColorCount.store(blocksUsed, std::memory_order_relaxed);
+    recordVersion_.fetch_add(1, std::memory_order_release);
+    if (onImprove_) onImprove_(bestPartition);
+}
+
+/*───────────────────────────────────────────────────────────────*/
+/*  рекорд для узла в кадре depth: свой рекорд обхода и общий,    */
+/*  если его лист левее узла; лист правее вытесняется и равным χ  */
+int OlemskoyColorGraph::bound(SearchState& st, int depth)
+{
+    if (st.seenVersion != recordVersion_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lk(bestMutex_);
+        st.seenVersion = recordVersion_.load(std::memory_order_relaxed);
+        st.recordChi   = bestColorCount.load(std::memory_order_relaxed);
+        st.recordPath  = bestPath_;
+    }
+
+    bool right = false;
+    const int common = std::min<int>(depth, st.recordPath.size());
+    for (int k = 0; k < common; ++k)
+        if (st.recordPath[k] != st.path[k]) { right = st.recordPath[k] > st.path[k]; break; }
+    return std::min(st.best, st.recordChi + (right ? 1 : 0));
 }
@@ -1,26 +1,90 @@
 #ifndef OLEMSKOY_COLOR_GRAPH_H
 #define OLEMSKOY_COLOR_GRAPH_H
 
+#include <atomic>
+#include <mutex>
+#include <string>
 #include <vector>
-#include <unordered_map>
+#include <deque>
+#include <functional>
 #include <unordered_set>
-#include <utility>      // std::pair
 #include <algorithm>
 
 #include "Graph.h"
 #include "GPair.h"
+#include "OlemskoyTrace.h"
+#include "../SearchStats.h"
+
+class WorkStealingPool;
 
 /*---------------------------------------------------------------*
- |  общий ключ (j,s) = (blockIndex, level)                       |
+ |  данные одного уровня (j,s) = (blockIndex, level)             |
+ |                                                                |
+ |  Уровни создаются и снимаются строго в порядке DFS, поэтому    |
+ |  хранятся стеком: кадр (j,s) лежит по индексу base[j] + s.     |
+ |  Буферы кадров переиспользуются между возвратами.              |
  *---------------------------------------------------------------*/
-using Key = std::pair<int,int>;
+struct LevelFrame
+{
+    std::vector<int>   omega;      // ω^{j,s}
+    std::vector<GPair> G;          // G^{j,s}
+    std::vector<QPair> Q;          // Q^{j,s}
+    std::vector<int>   F;          // F^{j,s}
+    bool               live = false;   // G и Q установлены (setLevelData)
+};
 
-struct PairHash {
-    std::size_t operator()(const Key& k) const noexcept
-    {
-        return (static_cast<std::size_t>(k.first) << 32) ^
-                static_cast<std::size_t>(k.second);
-    }
+/*---------------------------------------------------------------*
+ |  состояние одного обхода: у последовательного поиска оно одно, |
+ |  в параллельном каждая задача получает свою копию пути         |
+ *---------------------------------------------------------------*/
+struct SearchState
+{
+    std::vector<bool>             used;              // вершина уже «закрыта»?
+    std::vector<std::vector<int>> currentPartition;  // построенные блоки
+    std::vector<int>              r_j;               // последний уровень блока j
+
+    /*----------- стек уровней ω, Q, F, G -----------------------*/
+    std::deque<LevelFrame> frames;       // deque: ссылки на кадры стабильны
+    std::vector<int>       blockBase;    // индекс кадра (j,0)
+    GPairScratch           gpScratch;
+
+    /*----------- буферы Ψ/Z-прореживания ----------------------*/
+    std::vector<int> mark;               // mark[v] == stamp → v ∈ skip
+    int              stamp = 0;
+    std::vector<int> psi, Z, singles;
+
+    otrace::Recorder* trace = nullptr;   // трасса рабочего потока
+    SearchStats*      stats = nullptr;   // статистика рабочего потока
+
+    int              uncoloured = 0;     // незакрашенных вершин (ω и вне ω)
+    std::vector<int> path;               // path[k] — номер пары, выбранной в кадре k
+
+    /* свой рекорд обхода и копия общего (χ, путь листа) на момент
+       recordVersion == seenVersion; по ним проверки A/B/C (bound)   */
+    int              best = 0;
+    unsigned         seenVersion = 0;
+    int              recordChi   = 0;
+    std::vector<int> recordPath;
+
+    void reset(int n);
+
+    // копия пути до кадра (j,s) включительно, без сохранённых G
+    SearchState snapshot(int j, int s) const;
+
+    LevelFrame&       frame(int j, int s);
+    const LevelFrame& frame(int j, int s) const;
+
+    void setLevelData(int j, int s);                  // отметить G готовым, обнулить Q,F
+    void addQ(int j,int s,int q, int r);              // Q^{j,s} ← … ∪ {(q,r)}
+    void addF(int j,int s,int q, int r);              // F^{j,s} ← … ∪ {q, r}
+    void addF(int j,int s,int v);                     // F^{j,s} ← … ∪ {v}
+    void eraseLevel(int j,int s);                     // снять уровень
+
+    /* получение ω,Q,F,G – безопасно, без исключений */
+    const std::vector<int>&                     getOmega(int j,int s) const;
+    const std::vector<QPair>&                   getQ    (int j,int s) const;
+    const std::vector<int>&                     getF    (int j,int s) const;
+    const std::vector<GPair>&                   getG    (int j,int s) const;
 };
 
 /*================================================================*/
@@ -34,59 +98,92 @@ private:
     int   n = 0;
 
     /*------------- найденное лучшее решение ---*/
-    int bestColorCount           = 0;    // минимальное χ
-    int bestColorBottomLineColor = -1;   // нижняя оценка из проверки B
+    /* Рекорд — минимальный ключ (χ, путь листа): пути сравниваются
+       лексикографически, т. е. в порядке DFS, как номера задач в
+       ParallelBnB.h. Узел отсекается по рекорду левее себя как обычно,
+       а по рекорду правее — только если не может дать даже равное χ.
+       A и C — нижние оценки χ, B — правило «первый блок не меньше
+       ⌊n/χ⌋ + 1», которому лист обязан удовлетворять и сам; поэтому
+       итог — самый левый оптимальный лист, при любом расписании.     */
+    std::atomic<int> bestColorCount{0};              // минимальное χ
+    std::atomic<int> bestColorBottomLineColor{-1};   // нижняя оценка из проверки B
     std::vector<std::vector<int>> bestPartition;
+    std::vector<int>              bestPath_;         // путь листа bestPartition
+    std::atomic<unsigned>         recordVersion_{0}; // растёт с каждым рекордом
+    std::mutex                    bestMutex_;        // защищает bestPartition, bestPath_
 
-    /*------------- текущее состояние поиска ---*/
-    std::vector<bool>             used;              // вершина уже «закрыта»?
-    std::vector<std::vector<int>> currentPartition;  // построенные блоки
     std::unordered_set<long long> firstBlockSeen;    // симметр-кэш 1-го блока
 
-    /*----------- хранение ω, Q, F, G по (j,s) -------------*/
-    std::unordered_map<Key, std::vector<int>, PairHash> omega_;
-    std::unordered_map<Key, std::vector<std::vector<int>>, PairHash> Q_;
-    std::unordered_map<Key, std::vector<int>, PairHash> F_;
-    std::unordered_map<Key, std::vector<GPair>, PairHash> G_;
-    std::unordered_map<Key, std::vector<GPair>, PairHash> Z_;
-
-    /*------------- служебные методы -------------*/
-    void setLevelData(int j, int s,
-                      const std::vector<int>&   omega,
-                      const std::vector<GPair>& G);   // сохранить ω и G, обнулить Q,F
-    void setOmega(int j,int s, const std::vector<int>& omega);              // F^{j,s} ← … ∪ {q, r}
-    void addQ(int j,int s,int q, int r);              // Q^{j,s} ← … ∪ {(q,r)}
-    void addF(int j,int s,int q, int r);              // F^{j,s} ← … ∪ {q, r}
-    void addF(int j,int s,int v);                     // F^{j,s} ← … ∪ {v}
-    void eraseLevel(int j,int s);                     // удалить все 4 контейнера
+    /*------------- последовательный поиск -----*/
+    SearchState state_;
+    otrace::Recorder trace_;
+    SearchStats      stats_;
 
-    /* получение ω,Q,F,G,Z – безопасно, без исключений */
-    const std::vector<int>&                     getOmega(int j,int s) const;
-    const std::vector<std::vector<int>>&        getQ    (int j,int s) const;
-    const std::vector<int>&                     getF    (int j,int s) const;
-    const std::vector<GPair>&                   getG    (int j,int s) const;
-    const std::vector<GPair>&                   getZ    (int j,int s) const;
+    /*------------- параллельный поиск ---------*/
+    WorkStealingPool*             pool_ = nullptr;   // != nullptr во время параллельного поиска
+    std::vector<otrace::Recorder> workerTraces_;
+    std::vector<SearchStats>      workerStats_;
+
+    /*------------- внешнее управление (Portfolio.h) -*/
+    const std::atomic<bool>* cancel_ = nullptr;
+    std::function<void(const std::vector<std::vector<int>>&)> onImprove_;
+
+    bool cancelled() const { return cancel_ && cancel_->load(std::memory_order_relaxed); }
 
     /*------------- рекурсивные процедуры -------*/
-    void searchBlocks(int currentBlockIndex);
-    void buildBlock  (int blockIndex, int level,
-                      std::vector<int>&       currentBlock,
-                      const std::vector<int>& omega,
-                    std::vector<int>& r_j
-                    );
+    void searchBlocks(SearchState& st, int currentBlockIndex);
+    void buildBlock  (SearchState& st, int blockIndex, int level,
+                      std::vector<int>& currentBlock);   // ω берётся из кадра (j,s)
+    void tryPair     (SearchState& st, int blockIndex, int level,
+                      const GPair& pr, std::vector<int>& currentBlock);
+    void spawnPair   (const SearchState& st, int blockIndex, int level,
+                      const GPair& pr, const std::vector<int>& currentBlock);
+    void publish     (SearchState& st, int blocksUsed, int depth);  // рекорд обхода → общий
+    int  bound       (SearchState& st, int depth);       // рекорд для узла в кадре depth
 
     /*------------- Ψ/Z-прореживание ------------*/
-    std::vector<int> computePsi(int j,
-                            int s,
-                            const std::vector<int>& J) const;
+    void computePsi(SearchState& st, int j, int s, const std::vector<int>& J,
+                    std::vector<int>& psi) const;
+
+    void pruneOmega(SearchState& st, int j, int s, const std::vector<int>& J,
+                    std::vector<int>& pruned) const;
 
-    std::vector<int> pruneOmega(int j, int s, const std::vector<int>& J) const;
+    void prepare();
 
 public:
     explicit OlemskoyColorGraph(const Graph& matrix);
 
     // результат — список цветовых классов
     std::vector<std::vector<int>> resultColorNodes();
+
+    // то же на пуле из threads потоков (0 — по числу ядер): рекорд
+    // общий, простаивающий рабочий получает поддерево очередной пары
+    // на любом уровне. Результат тот же, что у resultColorNodes, при
+    // любом threads и расписании.
+    std::vector<std::vector<int>> resultColorNodesParallel(unsigned threads = 0);
+
+    // счётчики и записи трассы; пусты при OLEMSKOY_TRACE_LEVEL == 0.
+    // В параллельном режиме счётчики рабочих суммируются сюда, а записи
+    // содержат только Start и Finish.
+    const otrace::Recorder& trace() const { return trace_; }
+
+    // работа последнего поиска: узел — уровень (j,s), глубина — номер
+    // кадра; отсечения A, B, C и Ψ\Z; время построения G-пар.
+    // Собирается всегда, независимо от OLEMSKOY_TRACE_LEVEL.
+    const SearchStats& stats() const { return stats_; }
+
+    // внешняя остановка: как только *flag == true, поиск сворачивается,
+    // результат — лучшее разбиение, найденное к этому моменту
+    void setCancelFlag(const std::atomic<bool>* flag) { cancel_ = flag; }
+
+    // f(разбиение) — при каждом новом рекорде, под его блокировкой
+    void setImproveCallback(std::function<void(const std::vector<std::vector<int>>&)> f)
+    {
+        onImprove_ = std::move(f);
+    }
+
+    // двоичный дамп трассы; текст — olemskoy_trace_decode <file>
+    void writeTrace(const std::string& fileName) const { trace_.save(fileName); }
 };
 
 #endif  // OLEMSKOY_COLOR_GRAPH_H
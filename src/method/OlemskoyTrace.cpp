@@ -0,0 +1,271 @@
+#include "OlemskoyTrace.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace otrace
+{
+
+/* заголовок файла трассы */
+static constexpr std::uint32_t kMagic   = 0x3152544F;   // "OTR1"
+static constexpr std::uint32_t kVersion = 1;
+
+const char* eventName(Event e)
+{
+    switch (e) {
+        case Event::GraphSize:  return "graph_size";
+        case Event::Start:      return "start";
+        case Event::Finish:     return "finish";
+        case Event::Psi:        return "psi";
+        case Event::Z:          return "z";
+        case Event::PsiMinusZ:  return "psi_minus_z";
+        case Event::AllColored: return "all_colored";
+        case Event::NewBest:    return "new_best";
+        case Event::OmegaEmpty: return "omega_empty";
+        case Event::Block:      return "block";
+        case Event::Single:     return "single";
+        case Event::QState:     return "q_state";
+        case Event::FState:     return "f_state";
+        case Event::Partition:  return "partition";
+        case Event::Omega:      return "omega";
+        case Event::QLevel:     return "q_level";
+        case Event::GPairs:     return "gpairs";
+        case Event::BlockLevel: return "block_level";
+        case Event::CheckA:     return "check_a";
+        case Event::CheckAFail: return "check_a_fail";
+        case Event::CheckB:     return "check_b";
+        case Event::CheckBPass: return "check_b_pass";
+        case Event::LowerBound: return "lower_bound";
+        case Event::CheckBFail: return "check_b_fail";
+        case Event::CheckCFail: return "check_c_fail";
+        case Event::Count:      break;
+    }
+    return "unknown";
+}
+
+/*---------------------------------------------------------------*
+ |  Recorder                                                      |
+ *---------------------------------------------------------------*/
+void Recorder::save(std::ostream& out) const
+{
+    const std::uint64_t words = tail_ - head_;
+    out.write(reinterpret_cast<const char*>(&kMagic),   sizeof kMagic);
+    out.write(reinterpret_cast<const char*>(&kVersion), sizeof kVersion);
+    out.write(reinterpret_cast<const char*>(&words),    sizeof words);
+    out.write(reinterpret_cast<const char*>(&dropped_), sizeof dropped_);
+
+    /* сохранившиеся записи: не более двух непрерывных кусков кольца */
+    std::uint64_t pos = head_;
+    while (pos < tail_) {
+        std::size_t at    = static_cast<std::size_t>(pos & (capacity_ - 1));
+        std::size_t chunk = std::min<std::uint64_t>(tail_ - pos, capacity_ - at);
+        out.write(reinterpret_cast<const char*>(ring_.data() + at),
+                  static_cast<std::streamsize>(chunk * sizeof(std::uint32_t)));
+        pos += chunk;
+    }
+}
+
+void Recorder::save(const std::string& fileName) const
+{
+    std::ofstream fout(fileName, std::ios::binary);
+    if (!fout) throw std::runtime_error("Cannot open " + fileName);
+    save(fout);
+}
+
+void Recorder::printCounters(std::ostream& out) const
+{
+    for (int e = 0; e < kEventCount; ++e)
+        out << eventName(static_cast<Event>(e)) << ": " << counters_[e] << '\n';
+    if (dropped_) out << "dropped: " << dropped_ << '\n';
+}
+
+/*---------------------------------------------------------------*
+ |  decode                                                        |
+ *---------------------------------------------------------------*/
+namespace
+{
+class Reader
+{
+public:
+    Reader(const std::uint32_t* p, const std::uint32_t* end) : p_(p), end_(end) {}
+
+    int integer()
+    {
+        if (p_ == end_) throw std::runtime_error("Truncated trace record");
+        return static_cast<int>(*p_++);
+    }
+    std::vector<int> ints()
+    {
+        std::vector<int> v(count());
+        for (int& x : v) x = integer();
+        return v;
+    }
+    std::vector<QPair> qpairs()
+    {
+        std::vector<QPair> q(count());
+        for (auto& pr : q) { pr[0] = integer(); pr[1] = integer(); }
+        return q;
+    }
+    std::vector<GPair> gpairs()
+    {
+        std::vector<GPair> gp(count());
+        for (auto& pr : gp) { pr.i = integer(); pr.j = integer(); pr.set = ints(); }
+        return gp;
+    }
+    std::vector<std::vector<int>> sets()
+    {
+        std::vector<std::vector<int>> vv(count());
+        for (auto& v : vv) v = ints();
+        return vv;
+    }
+
+private:
+    const std::uint32_t* p_;
+    const std::uint32_t* end_;
+
+    std::size_t count()
+    {
+        int c = integer();
+        if (c < 0 || c > end_ - p_) throw std::runtime_error("Corrupt trace record");
+        return static_cast<std::size_t>(c);
+    }
+};
+} // namespace
+
+void decode(std::istream& in, std::ostream& out)
+{
+    std::uint32_t magic = 0, version = 0;
+    std::uint64_t words = 0, dropped = 0;
+    in.read(reinterpret_cast<char*>(&magic),   sizeof magic);
+    in.read(reinterpret_cast<char*>(&version), sizeof version);
+    in.read(reinterpret_cast<char*>(&words),   sizeof words);
+    in.read(reinterpret_cast<char*>(&dropped), sizeof dropped);
+    if (!in || magic != kMagic)    throw std::runtime_error("Not an Olemskoy trace");
+    if (version != kVersion)       throw std::runtime_error("Unsupported trace version");
+
+    std::vector<std::uint32_t> buf(static_cast<std::size_t>(words));
+    in.read(reinterpret_cast<char*>(buf.data()),
+            static_cast<std::streamsize>(buf.size() * sizeof(std::uint32_t)));
+    if (!in) throw std::runtime_error("Truncated trace");
+
+    if (dropped)
+        out << "... " << dropped << " earlier records overwritten ...\n";
+
+    std::size_t pos = 0;
+    while (pos < buf.size()) {
+        const std::uint32_t header = buf[pos++];
+        const auto          ev     = static_cast<Event>(header >> 24);
+        const std::size_t   len    = header & 0xFFFFFFu;
+        if (len > buf.size() - pos) throw std::runtime_error("Truncated trace record");
+
+        Reader r(buf.data() + pos, buf.data() + pos + len);
+        pos += len;
+
+        switch (ev) {
+        case Event::GraphSize:
+            out << "Graph n = " << r.integer() << '\n';
+            break;
+        case Event::Start:
+            out << "--- Начало алгоритма --- \n";
+            break;
+        case Event::Finish:
+            out << "--- Алгоритм закончен, минимальное количество цветов: "
+                << r.integer() << " ---\n";
+            break;
+        case Event::Psi:
+        case Event::Z:
+        case Event::PsiMinusZ: {
+            int j = r.integer(), s = r.integer();
+            const char* name = ev == Event::Psi ? "Ψ" : ev == Event::Z ? "Z" : "Ψ\\Z";
+            out << name << " (" << j << ", " << s << ")" << r.ints() << '\n';
+            break;
+        }
+        case Event::AllColored:
+            out << "Все вершины покрашены в " << r.integer() << " блоков/блока\n";
+            break;
+        case Event::NewBest:
+            out << "Найдено меньшее хроматическое число! Оно равно "
+                << r.integer() << " \n";
+            break;
+        case Event::OmegaEmpty: {
+            int j = r.integer(), s = r.integer();
+            out << "Опорное множество(" << j << ", " << s
+                << "): " << r.ints() << "пусто \n";
+            break;
+        }
+        case Event::Block: {
+            int j = r.integer(), s = r.integer();
+            out << "Блок(" << j << ", " << s << "): " << r.ints() << "\n";
+            break;
+        }
+        case Event::Single:
+            out << "Добавлена единичная вершина: " << r.integer() << '\n';
+            break;
+        case Event::QState: {
+            int j = r.integer(), s = r.integer();
+            out << "Q(" << j << ", " << s << ") = " << r.qpairs() << '\n';
+            break;
+        }
+        case Event::FState: {
+            int j = r.integer(), s = r.integer();
+            out << "F(" << j << ", " << s << ") = " << r.ints() << '\n';
+            break;
+        }
+        case Event::Partition:
+            out << "Текущий набор блоков: " << r.sets() << "\n";
+            break;
+        case Event::Omega: {
+            int j = r.integer(), s = r.integer();
+            out << "Опорное множество(" << j << ", " << s << "): " << r.ints() << "\n";
+            break;
+        }
+        case Event::QLevel: {
+            int j = r.integer(), s = r.integer();
+            out << "Q: (" << j << ", " << s << "): " << r.qpairs() << '\n';
+            break;
+        }
+        case Event::GPairs:
+            out << "Возможные варианты продолжений G\\Q " << r.gpairs() << '\n';
+            break;
+        case Event::BlockLevel: {
+            int j = r.integer(), s = r.integer();
+            out << "Номер текущего блока: " << j << ", уровень: " << s << '\n';
+            break;
+        }
+        case Event::CheckA: {
+            int j = r.integer(), rest = r.integer(), best = r.integer();
+            out << "Проверка A [" << j << "] " << j << " + " << rest
+                << " < " << best << "\n";
+            break;
+        }
+        case Event::CheckAFail:
+            out << "проверка A провалена\n";
+            break;
+        case Event::CheckB: {
+            int j = r.integer(), twoS = r.integer(), ro = r.integer(), fl = r.integer();
+            out << "Проверка В [" << j << "] " << twoS << " + " << ro << " > "
+                << fl << "\n";
+            break;
+        }
+        case Event::CheckBPass:
+            out << "проверка В успешна\n";
+            break;
+        case Event::LowerBound:
+            out << "Получена нижняя оценка χ: " << r.integer() << "\n";
+            break;
+        case Event::CheckBFail:
+            out << "проверка В провалена\n";
+            break;
+        case Event::CheckCFail:
+            out << "проверка C провалена\n";
+            break;
+        default:
+            throw std::runtime_error("Unknown trace event");
+        }
+    }
+}
+
+} // namespace otrace
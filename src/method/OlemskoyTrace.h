@@ -0,0 +1,198 @@
+#ifndef OLEMSKOY_TRACE_H
+#define OLEMSKOY_TRACE_H
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "GPair.h"
+
+/*---------------------------------------------------------------*
+ |  Трассировка метода Олемского                                 |
+ |                                                                |
+ |  OLEMSKOY_TRACE_LEVEL (задаётся CMake-опцией OLEMSKOY_TRACE):  |
+ |    0 – выключена, вызовы вырезаются препроцессором;            |
+ |    1 – только счётчики событий;                                |
+ |    2 – полная трасса: счётчики + двоичные записи в кольцевой   |
+ |        буфер экземпляра; текст olemskoy_steps.txt получается   |
+ |        офлайн через otrace::decode (olemskoy_trace_decode).    |
+ *---------------------------------------------------------------*/
+#ifndef OLEMSKOY_TRACE_LEVEL
+#define OLEMSKOY_TRACE_LEVEL 0
+#endif
+
+#if OLEMSKOY_TRACE_LEVEL >= 2
+#define OLEMSKOY_TRACE(rec, ...) (rec).record(::otrace::Event::__VA_ARGS__)
+#elif OLEMSKOY_TRACE_LEVEL == 1
+#define OLEMSKOY_TRACE_EVENT_(ev, ...) ev
+#define OLEMSKOY_TRACE(rec, ...) \
+    (rec).count(::otrace::Event::OLEMSKOY_TRACE_EVENT_(__VA_ARGS__, _))
+#else
+#define OLEMSKOY_TRACE(rec, ...) ((void)0)
+#endif
+
+namespace otrace
+{
+
+/*  события: имя ← полезная нагрузка (в порядке записи)  */
+enum class Event : std::uint8_t
+{
+    GraphSize,      // n
+    Start,          //
+    Finish,         // bestColorCount
+    Psi,            // j, s, Ψ
+    Z,              // j, s, Z
+    PsiMinusZ,      // j, s, Ψ\Z
+    AllColored,     // blocksUsed
+    NewBest,        // bestColorCount
+    OmegaEmpty,     // j, s, ω
+    Block,          // j, s, блок
+    Single,         // v
+    QState,         // j, s, Q
+    FState,         // j, s, F
+    Partition,      // текущий набор блоков
+    Omega,          // j, s, ω
+    QLevel,         // j, s, Q
+    GPairs,         // G\Q
+    BlockLevel,     // j, s
+    CheckA,         // j, |ω|/ρ, bestColorCount
+    CheckAFail,     //
+    CheckB,         // j, 2s, ρ, ⌊n/best⌋
+    CheckBPass,     //
+    LowerBound,     // bestColorBottomLineColor
+    CheckBFail,     //
+    CheckCFail,     //
+    Count
+};
+
+constexpr int kEventCount = static_cast<int>(Event::Count);
+
+const char* eventName(Event e);
+
+/*---------------------------------------------------------------*
+ |  Recorder: счётчики + кольцевой буфер 32-битных слов.         |
+ |  Запись = заголовок (событие << 24 | длина) + нагрузка.        |
+ |  При переполнении вытесняются самые старые записи целиком.     |
+ *---------------------------------------------------------------*/
+class Recorder
+{
+public:
+    static constexpr std::size_t kDefaultCapacityWords = std::size_t{1} << 22;   // 16 МБ
+
+    explicit Recorder(std::size_t capacityWords = kDefaultCapacityWords)
+    {
+        std::size_t cap = 1;
+        while (cap < capacityWords) cap <<= 1;
+        capacity_ = cap;
+        counters_.fill(0);
+    }
+
+    void count(Event e) { ++counters_[static_cast<int>(e)]; }
+
+    template<class... Args>
+    void record(Event e, const Args&... args)
+    {
+        count(e);
+        const std::size_t len = (std::size_t{0} + ... + encodedWords(args));
+        if (len + 1 > capacity_ || len >= (std::size_t{1} << 24)) { ++dropped_; return; }
+        if (ring_.empty()) ring_.assign(capacity_, 0);       // память — только при FULL
+
+        while (tail_ + len + 1 - head_ > capacity_) {        // вытесняем старые записи
+            head_ += (ring_[head_ & (capacity_ - 1)] & 0xFFFFFFu) + 1;
+            ++dropped_;
+        }
+        push((static_cast<std::uint32_t>(e) << 24) | static_cast<std::uint32_t>(len));
+        (encode(args), ...);
+    }
+
+    const std::array<std::uint64_t, kEventCount>& counters() const { return counters_; }
+    std::uint64_t counter(Event e) const { return counters_[static_cast<int>(e)]; }
+    std::uint64_t dropped() const { return dropped_; }
+
+    // прибавить счётчики другого рекордера (рабочие параллельного поиска)
+    void mergeCounters(const Recorder& other)
+    {
+        for (int e = 0; e < kEventCount; ++e) counters_[e] += other.counters_[e];
+        dropped_ += other.dropped_;
+    }
+
+    void clear()
+    {
+        counters_.fill(0);
+        head_ = tail_ = 0;
+        dropped_ = 0;
+    }
+
+    // двоичный дамп сохранившихся записей (формат читает decode)
+    void save(std::ostream& out) const;
+    void save(const std::string& fileName) const;
+
+    // счётчики в виде «имя: значение» по строке
+    void printCounters(std::ostream& out) const;
+
+private:
+    std::vector<std::uint32_t>             ring_;
+    std::size_t                            capacity_ = 0;     // степень двойки
+    std::uint64_t                          head_ = 0, tail_ = 0;
+    std::uint64_t                          dropped_ = 0;
+    std::array<std::uint64_t, kEventCount> counters_{};
+
+    void push(std::uint32_t w) { ring_[tail_++ & (capacity_ - 1)] = w; }
+    void push(int v)           { push(static_cast<std::uint32_t>(v)); }
+
+    /* ---------- кодирование нагрузки ---------- */
+    static std::size_t encodedWords(int)                                   { return 1; }
+    static std::size_t encodedWords(const std::vector<int>& v)             { return 1 + v.size(); }
+    static std::size_t encodedWords(const std::vector<QPair>& q)           { return 1 + 2 * q.size(); }
+    static std::size_t encodedWords(const std::vector<GPair>& gp)
+    {
+        std::size_t w = 1;
+        for (const auto& p : gp) w += 3 + p.set.size();
+        return w;
+    }
+    static std::size_t encodedWords(const std::vector<std::vector<int>>& vv)
+    {
+        std::size_t w = 1;
+        for (const auto& v : vv) w += 1 + v.size();
+        return w;
+    }
+
+    void encode(int v) { push(v); }
+    void encode(const std::vector<int>& v)
+    {
+        push(static_cast<int>(v.size()));
+        for (int x : v) push(x);
+    }
+    void encode(const std::vector<QPair>& q)
+    {
+        push(static_cast<int>(q.size()));
+        for (const auto& p : q) { push(p[0]); push(p[1]); }
+    }
+    void encode(const std::vector<GPair>& gp)
+    {
+        push(static_cast<int>(gp.size()));
+        for (const auto& p : gp) {
+            push(p.i);
+            push(p.j);
+            encode(p.set);
+        }
+    }
+    void encode(const std::vector<std::vector<int>>& vv)
+    {
+        push(static_cast<int>(vv.size()));
+        for (const auto& v : vv) encode(v);
+    }
+};
+
+/*---------------------------------------------------------------*
+ |  decode: двоичный дамп Recorder::save  →  текст в формате      |
+ |  прежнего olemskoy_steps.txt. Бросает std::runtime_error на    |
+ |  повреждённом входе.                                           |
+ *---------------------------------------------------------------*/
+void decode(std::istream& in, std::ostream& out);
+
+} // namespace otrace
+
+#endif // OLEMSKOY_TRACE_H
@@ -48,4 +48,15 @@ std::ostream& operator<<(std::ostream& os, const std::vector<std::vector<int>>&
         os << "["  << i << "]" << vectors[i];
     }
     return os;
+}
+
+//-----------------------------------------------------------------------------
+// std::vector<std::array<int,2>>: prints Q pairs in the same layout as sets
+//-----------------------------------------------------------------------------
+std::ostream& operator<<(std::ostream& os, const std::vector<std::array<int,2>>& pairs) {
+    os << "[Sets] \n";
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        os << "["  << i << "]" << " { " << pairs[i][0] << ", " << pairs[i][1] << " } " << '\n';
+    }
+    return os;
 }
\ No newline at end of file
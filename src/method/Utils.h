@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <vector>
 #include <iosfwd>
 
@@ -11,3 +12,5 @@ std::ostream& operator<<(std::ostream& os, const std::vector<GPair>& gPairs);
 std::ostream& operator<<(std::ostream& os, const std::vector<int>& intVector);
 std::ostream& operator<<(std::ostream& os, const std::vector<std::vector<int>>& intVectors);
 
+
+std::ostream& operator<<(std::ostream& os, const std::vector<std::array<int,2>>& pairs);
\ No newline at end of file
@@ -0,0 +1,473 @@
+/*---------------------------------------------------------------*
+ |  coloring_bench: замеры алгоритмов раскраски                    |
+ |                                                                 |
+ |  Графы — случайные G(n, d) по зерну (RandomGraph.h) и/или        |
+ |  файлы: .ogb (GraphBinary.h), .col/.clq (DIMACS), .el/.edges     |
+ |  (список рёбер), остальное — формат graphs.txt.                  |
+ |  На каждую пару (граф, алгоритм): warmup прогонов без замера,    |
+ |  repeat замеров; в отчёт — χ, корректность раскраски (проверка   |
+ |  вне замера), min / median / p95 / mean времени. С --perf —      |
+ |  ещё медианы аппаратных счётчиков по замерам (PerfCounters.h);   |
+ |  если счётчики недоступны, столбцы пустые. С --reduce алгоритм   |
+ |  получает ядро графа (Kernelization.h), а время включает         |
+ |  сокращение и возврат снятых вершин. С --split components|blocks  |
+ |  граф режется на компоненты или блоки (Components.h), и они      |
+ |  решаются параллельно на --threads потоках. С --relabel           |
+ |  degree|degeneracy|rcm алгоритм получает перенумерованную копию   |
+ |  (Relabel.h), раскраска возвращается в исходные номера.          |
+ |                                                                 |
+ |  usage: coloring_bench [--algo a,b,…] [--n 10,20] [--density …]  |
+ |           [--seed 1,2] [--input file]… [--warmup W] [--repeat R] |
+ |           [--threads T] [--perf] [--reduce] [--split S]          |
+ |           [--relabel O]                                         |
+ |           [--csv out.csv]                                       |
+ |           [--json out.json]                                     |
+ |         coloring_bench --list                                    |
+ *---------------------------------------------------------------*/
+#include "Benchmark.h"
+#include "GraphBinary.h"
+#include "GraphIO.h"
+#include "RandomGraph.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/* алгоритм: граф → цвета 0-based; точные решатели заполняют stats */
+struct Algorithm
+{
+    const char* name;
+    std::function<std::vector<int>(const CsrGraph&, unsigned threads, SearchStats*)> run;
+};
+
+std::vector<int> fromGroups(std::size_t n, const std::vector<std::vector<int>>& groups)
+{
+    std::vector<int> col(n, -1);
+    for (std::size_t c = 0; c < groups.size(); ++c)
+        for (int v : groups[c]) col[v] = static_cast<int>(c);
+    return col;
+}
+
+const std::vector<Algorithm>& algorithms()
+{
+    static const std::vector<Algorithm> all = {
+        {"greedy",       [](const CsrGraph& g, unsigned, SearchStats*)   { return GreedyColoring::color(g); }},
+        {"dsatur",       [](const CsrGraph& g, unsigned, SearchStats*)   { return DSaturColoring::color(g); }},
+        {"heuristic",    [](const CsrGraph& g, unsigned t, SearchStats*) {
+            auto col = greedy::Coloring<CsrGraph>(g, 10000, t).colors();   // 1-based
+            for (int& c : col) --c;
+            return col;
+        }},
+        {"bnb",          [](const CsrGraph& g, unsigned, SearchStats* s)   { return DSaturBnB::color(g, s); }},
+        {"bnb-par",      [](const CsrGraph& g, unsigned t, SearchStats* s) { return DSaturBnB::colorParallel(g, t, s); }},
+        {"mis",          [](const CsrGraph& g, unsigned, SearchStats* s)   { return BacktrackingColoring::color(g, s); }},
+        {"mis-par",      [](const CsrGraph& g, unsigned t, SearchStats* s) { return BacktrackingColoring::colorParallel(g, t, s); }},
+        {"olemskoy",     [](const CsrGraph& g, unsigned, SearchStats* s)   {
+            Graph G(g);
+            OlemskoyColorGraph solver(G);
+            auto col = fromGroups(g.size(), solver.resultColorNodes());
+            *s = solver.stats();
+            return col;
+        }},
+        {"olemskoy-par", [](const CsrGraph& g, unsigned t, SearchStats* s) {
+            Graph G(g);
+            OlemskoyColorGraph solver(G);
+            auto col = fromGroups(g.size(), solver.resultColorNodesParallel(t));
+            *s = solver.stats();
+            return col;
+        }},
+        {"portfolio",    [](const CsrGraph& g, unsigned t, SearchStats* s) {
+            portfolio::Options opt;
+            opt.heuristicThreads = t ? t : 1;
+            auto res = portfolio::solve(g, opt);
+            *s = std::move(res.stats);
+            return res.colouring;
+        }},
+    };
+    return all;
+}
+
+/* граф для замеров */
+struct Instance
+{
+    std::string   source;            // "gnp" или имя файла
+    int           index   = 0;       // номер графа в файле
+    CsrGraph      graph;
+    double        density = -1;      // < 0 — неизвестна
+    bool          seeded  = false;
+    std::uint64_t seed    = 0;
+};
+
+struct Result
+{
+    const Instance*     inst  = nullptr;
+    const char*         algo  = "";
+    int                 chi   = 0;
+    bool                valid = true;
+    std::vector<double> times;
+    TimeStats           stats;
+    SearchStats         work;            // последнего прогона; пусто у эвристик
+    long                reducedN = -1;   // вершин в ядре (--reduce)
+    long                parts    = -1;   // компонент или блоков (--split)
+    perf::Sample        perf;            // медианы по замерам
+};
+
+struct Options
+{
+    std::vector<std::string>   algos = {"greedy", "dsatur", "bnb", "mis"};
+    std::vector<int>           sizes;
+    std::vector<double>        densities = {0.15, 0.35, 0.55, 0.65, 0.75, 0.85};
+    std::vector<std::uint64_t> seeds = {1};
+    std::vector<std::string>   inputs;
+    int                        warmup = 1, repeat = 5;
+    unsigned                   threads = 0;
+    bool                       perf = false;
+    bool                       reduce = false;
+    std::string                split;           // "", "components", "blocks"
+    relabel::Order             relabel = relabel::Identity;
+    std::string                csv, json;
+};
+
+template<class T>
+std::vector<T> parseList(const std::string& s)
+{
+    std::vector<T> out;
+    std::istringstream in(s);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        std::istringstream one(item);
+        T v;
+        if (!(one >> v) || !(one >> std::ws).eof())
+            throw std::runtime_error("Bad list value: " + item);
+        out.push_back(v);
+    }
+    return out;
+}
+
+int usage(const char* self)
+{
+    std::cerr << "usage: " << self << " [--algo a,b,...] [--n 10,20] [--density 0.1,0.5]\n"
+              << "         [--seed 1,2] [--input file]... [--warmup W] [--repeat R]\n"
+              << "         [--threads T] [--perf] [--reduce] [--split components|blocks]\n"
+              << "         [--relabel degree|degeneracy|rcm]\n"
+              << "         [--csv out.csv] [--json out.json]\n"
+              << "       " << self << " --list\n";
+    return 2;
+}
+
+/* покомпонентная медиана счётчиков (нижняя при чётном числе) */
+perf::Sample medianSample(const std::vector<perf::Sample>& samples)
+{
+    perf::Sample m;
+    for (int e = 0; e < perf::kEventCount; ++e) {
+        std::vector<std::uint64_t> v;
+        for (const auto& s : samples) if (s.has(e)) v.push_back(s.value[e]);
+        if (v.empty()) continue;
+        std::nth_element(v.begin(), v.begin() + (v.size() - 1) / 2, v.end());
+        m.value[e] = v[(v.size() - 1) / 2];
+        m.ok[e]    = true;
+    }
+    for (const auto& s : samples) m.multiplexed = m.multiplexed || s.multiplexed;
+    return m;
+}
+
+bool endsWith(const std::string& s, const char* ext)
+{
+    const std::size_t k = std::strlen(ext);
+    return s.size() >= k && s.compare(s.size() - k, k, ext) == 0;
+}
+
+void loadInput(const std::string& file, std::vector<Instance>& out)
+{
+    if (endsWith(file, ".ogb")) {
+        graphio::BinaryGraphFile f(file, /*verify=*/true);
+        for (std::size_t i = 0; i < f.size(); ++i) {
+            const auto s = f[i];
+            out.push_back({file, static_cast<int>(i), s.graph, s.density});
+        }
+    } else if (endsWith(file, ".col") || endsWith(file, ".clq")) {
+        out.push_back({file, 0, graphio::readDimacs(file)});
+    } else if (endsWith(file, ".el") || endsWith(file, ".edges")) {
+        out.push_back({file, 0, graphio::readEdgeList(file)});
+    } else {
+        const auto graphs = loadGraphsParallel(file);
+        for (std::size_t i = 0; i < graphs.size(); ++i)
+            out.push_back({file, static_cast<int>(i), CsrGraph::fromDense(graphs[i].A),
+                           graphs[i].density});
+    }
+}
+
+std::string jsonString(const std::string& s)
+{
+    std::string out = "\"";
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') { out += '\\'; out += ch; }
+        else if (static_cast<unsigned char>(ch) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof buf, "\\u%04x", ch);
+            out += buf;
+        }
+        else out += ch;
+    }
+    return out + "\"";
+}
+
+std::string utcNow()
+{
+    const std::time_t t = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof buf, "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&t));
+    return buf;
+}
+
+void writeCsv(const std::string& file, const Options& o, const std::vector<Result>& rs)
+{
+    std::ofstream out(file);
+    if (!out) throw std::runtime_error("Cannot open " + file);
+    out << "algo,source,index,n,m,density,seed,threads,warmup,repeat,chi,valid,"
+           "min_s,median_s,p95_s,mean_s,reduced_n,parts,nodes,max_depth";
+    for (int p = 0; p < SearchStats::kPruneCount; ++p)
+        out << ",prune_" << SearchStats::pruneName(p);
+    out << ",improvements";
+    for (int e = 0; e < perf::kEventCount; ++e) out << ',' << perf::eventName(e);
+    out << ",ipc\n";
+    out << std::setprecision(9);
+    for (const auto& r : rs) {
+        const Instance& i = *r.inst;
+        out << r.algo << ',' << i.source << ',' << i.index << ',' << i.graph.size() << ','
+            << i.graph.edges() << ',';
+        if (i.density >= 0) out << i.density;
+        out << ',';
+        if (i.seeded) out << i.seed;
+        out << ',' << o.threads << ',' << o.warmup << ',' << o.repeat << ',' << r.chi << ','
+            << (r.valid ? 1 : 0) << ',' << r.stats.min << ',' << r.stats.median << ','
+            << r.stats.p95 << ',' << r.stats.mean << ',';
+        if (r.reducedN >= 0) out << r.reducedN;
+        out << ',';
+        if (r.parts >= 0) out << r.parts;
+        out << ',' << r.work.nodes << ',' << r.work.maxDepth;
+        for (auto p : r.work.prunes) out << ',' << p;
+        out << ',' << r.work.improvements.size();
+        for (int e = 0; e < perf::kEventCount; ++e) {
+            out << ',';
+            if (r.perf.has(e)) out << r.perf.value[e];
+        }
+        out << ',';
+        if (r.perf.ipc() > 0) out << r.perf.ipc();
+        out << '\n';
+    }
+}
+
+void writeJson(const std::string& file, const Options& o, const std::vector<Result>& rs,
+               const std::string& argv)
+{
+    std::ofstream out(file);
+    if (!out) throw std::runtime_error("Cannot open " + file);
+    out << std::setprecision(9);
+    out << "{\n  \"created\": " << jsonString(utcNow())
+        << ",\n  \"argv\": " << jsonString(argv)
+        << ",\n  \"compiler\": " << jsonString(__VERSION__)
+#ifdef NDEBUG
+        << ",\n  \"assertions\": false"
+#else
+        << ",\n  \"assertions\": true"
+#endif
+        << ",\n  \"hardware_threads\": " << std::thread::hardware_concurrency()
+        << ",\n  \"threads\": " << o.threads
+        << ",\n  \"warmup\": " << o.warmup
+        << ",\n  \"repeat\": " << o.repeat
+        << ",\n  \"perf\": " << (o.perf ? "true" : "false")
+        << ",\n  \"reduce\": " << (o.reduce ? "true" : "false")
+        << ",\n  \"split\": " << (o.split.empty() ? "null" : jsonString(o.split))
+        << ",\n  \"relabel\": " << jsonString(relabel::orderName(o.relabel))
+        << ",\n  \"results\": [";
+    for (std::size_t k = 0; k < rs.size(); ++k) {
+        const auto& r = rs[k];
+        const Instance& i = *r.inst;
+        out << (k ? "," : "") << "\n    {\"algo\": " << jsonString(r.algo)
+            << ", \"source\": " << jsonString(i.source) << ", \"index\": " << i.index
+            << ", \"n\": " << i.graph.size() << ", \"m\": " << i.graph.edges()
+            << ", \"density\": ";
+        if (i.density >= 0) out << i.density; else out << "null";
+        out << ", \"seed\": ";
+        if (i.seeded) out << i.seed; else out << "null";
+        out << ", \"chi\": " << r.chi << ", \"valid\": " << (r.valid ? "true" : "false")
+            << ", \"min_s\": " << r.stats.min << ", \"median_s\": " << r.stats.median
+            << ", \"p95_s\": " << r.stats.p95 << ", \"mean_s\": " << r.stats.mean
+            << ", \"reduced_n\": ";
+        if (r.reducedN >= 0) out << r.reducedN; else out << "null";
+        out << ", \"parts\": ";
+        if (r.parts >= 0) out << r.parts; else out << "null";
+        out
+            << ", \"times_s\": [";
+        for (std::size_t t = 0; t < r.times.size(); ++t) out << (t ? ", " : "") << r.times[t];
+
+        const SearchStats& w = r.work;
+        out << "], \"work\": {\"nodes\": " << w.nodes << ", \"max_depth\": " << w.maxDepth
+            << ", \"prunes\": {";
+        for (int p = 0; p < SearchStats::kPruneCount; ++p)
+            out << (p ? ", " : "") << jsonString(SearchStats::pruneName(p)) << ": " << w.prunes[p];
+        out << "}, \"improvements\": [";
+        for (std::size_t k = 0; k < w.improvements.size(); ++k)
+            out << (k ? ", " : "") << "{\"chi\": " << w.improvements[k].value
+                << ", \"at_s\": " << w.improvements[k].seconds << '}';
+        out << "], \"setup_s\": " << w.setupSeconds << ", \"gpair_s\": " << w.gpairSeconds()
+            << ", \"gpair_builds\": " << w.gpairBuilds
+            << ", \"search_s\": " << w.searchSeconds << '}';
+
+        out << ", \"perf\": ";
+        if (!r.perf.any()) out << "null";
+        else {
+            out << '{';
+            for (int e = 0; e < perf::kEventCount; ++e) {
+                out << (e ? ", " : "") << jsonString(perf::eventName(e)) << ": ";
+                if (r.perf.has(e)) out << r.perf.value[e]; else out << "null";
+            }
+            out << ", \"ipc\": ";
+            if (r.perf.ipc() > 0) out << r.perf.ipc(); else out << "null";
+            out << ", \"multiplexed\": " << (r.perf.multiplexed ? "true" : "false") << '}';
+        }
+        out << '}';
+    }
+    out << "\n  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options o;
+    std::string cmdline;
+    for (int i = 0; i < argc; ++i) cmdline += (i ? " " : "") + std::string(argv[i]);
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::runtime_error("Missing value for " + a);
+                return argv[++i];
+            };
+            if      (a == "--list")    { for (const auto& al : algorithms()) std::cout << al.name << '\n'; return 0; }
+            else if (a == "--algo")    o.algos     = parseList<std::string>(value());
+            else if (a == "--n")       o.sizes     = parseList<int>(value());
+            else if (a == "--density") o.densities = parseList<double>(value());
+            else if (a == "--seed")    o.seeds     = parseList<std::uint64_t>(value());
+            else if (a == "--input")   o.inputs.push_back(value());
+            else if (a == "--warmup")  o.warmup    = std::stoi(value());
+            else if (a == "--repeat")  o.repeat    = std::stoi(value());
+            else if (a == "--threads") o.threads   = static_cast<unsigned>(std::stoul(value()));
+            else if (a == "--perf")    o.perf      = true;
+            else if (a == "--reduce")  o.reduce    = true;
+            else if (a == "--split")   o.split     = value();
+            else if (a == "--relabel") o.relabel   = relabel::parseOrder(value());
+            else if (a == "--csv")     o.csv       = value();
+            else if (a == "--json")    o.json      = value();
+            else return usage(argv[0]);
+        }
+        if (o.sizes.empty() && o.inputs.empty()) o.sizes = {10};
+        if (!o.split.empty() && o.split != "components" && o.split != "blocks")
+            throw std::runtime_error("Unknown --split " + o.split + " (components or blocks)");
+
+        std::vector<const Algorithm*> algos;
+        for (const auto& name : o.algos) {
+            const Algorithm* found = nullptr;
+            for (const auto& al : algorithms()) if (name == al.name) found = &al;
+            if (!found) throw std::runtime_error("Unknown algorithm " + name + " (see --list)");
+            algos.push_back(found);
+        }
+
+        /* ---------- графы ---------- */
+        std::vector<Instance> instances;
+        for (int n : o.sizes)
+            for (double d : o.densities)
+                for (std::uint64_t seed : o.seeds)
+                    instances.push_back({"gnp", 0, RandomGraph::gnp(n, d, seed), d, true, seed});
+        for (const auto& file : o.inputs) loadInput(file, instances);
+
+        if (o.perf && !perf::Counters().available())
+            std::cerr << "perf counters unavailable (perf_event_open failed), timing only\n";
+
+        /* ---------- замеры ---------- */
+        std::vector<Result> results;
+        std::cout << std::left << std::setw(13) << "algo" << std::setw(28) << "graph"
+                  << std::right << std::setw(5) << "chi" << std::setw(7) << "valid"
+                  << std::setw(12) << "min,s" << std::setw(12) << "median,s"
+                  << std::setw(12) << "p95,s" << '\n';
+        for (const auto& inst : instances)
+            for (const Algorithm* al : algos) {
+                Result r;
+                r.inst = &inst;
+                r.algo = al->name;
+                std::vector<perf::Sample> samples;
+
+                /* части (--split) решаются параллельно: у каждой своя статистика */
+                std::mutex workMutex;
+                components::Split split;
+                auto runAlgo = [&](const CsrGraph& h, SearchStats* w) {
+                    return relabel::colour(h, [&](const CsrGraph& p) {
+                        return al->run(p, o.threads, w);
+                    }, o.relabel);
+                };
+                auto runOn = [&](const CsrGraph& h) {
+                    if (o.split.empty()) return runAlgo(h, &r.work);
+                    SearchStats w;
+                    auto col = runAlgo(h, &w);
+                    std::lock_guard<std::mutex> lk(workMutex);
+                    r.work.merge(w);
+                    return col;
+                };
+                auto splitRun = [&](const CsrGraph& h) {
+                    if (o.split.empty()) return runOn(h);
+                    components::Options so;
+                    so.blocks  = o.split == "blocks";
+                    so.threads = o.threads;
+                    return components::colour(h, runOn, so, &split);
+                };
+                auto [col, times] = timeRuns([&]{
+                    r.work = SearchStats{};
+                    if (!o.reduce) return splitRun(inst.graph);
+                    return kernel::colour(inst.graph, splitRun);
+                }, o.warmup, o.repeat, o.perf ? &samples : nullptr);
+                if (!o.split.empty()) r.parts = static_cast<long>(split.parts);
+                if (o.reduce) r.reducedN = static_cast<long>(kernel::Kernel(inst.graph).reduced().size());
+                r.valid = isProperColoring(inst.graph, col, false);
+                r.chi   = col.empty() ? 0 : *std::max_element(col.begin(), col.end()) + 1;
+                r.times = std::move(times);
+                r.stats = summarize(r.times);
+                r.perf  = medianSample(samples);
+
+                std::ostringstream name;
+                if (inst.seeded) name << "gnp n=" << inst.graph.size() << " d=" << inst.density
+                                      << " s=" << inst.seed;
+                else             name << inst.source << '#' << inst.index + 1;
+                std::cout << std::left << std::setw(13) << r.algo << std::setw(28) << name.str()
+                          << std::right << std::setw(5) << r.chi << std::setw(7)
+                          << (r.valid ? "yes" : "NO") << std::setprecision(4)
+                          << std::setw(12) << r.stats.min << std::setw(12) << r.stats.median
+                          << std::setw(12) << r.stats.p95 << '\n';
+                results.push_back(std::move(r));
+            }
+
+        if (!o.csv.empty())  writeCsv(o.csv, o, results);
+        if (!o.json.empty()) writeJson(o.json, o, results, cmdline);
+
+        for (const auto& r : results) if (!r.valid) return 3;   // некорректная раскраска
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
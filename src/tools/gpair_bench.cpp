@@ -0,0 +1,132 @@
+/*---------------------------------------------------------------*
+ |  gpair_bench: buildGPairsHV (упакованные строки) против        |
+ |  прежней реализации на списках H/V со сканами contains.        |
+ |                                                                 |
+ |  usage: gpair_bench [n=200] [density=0.75] [graphs=5] [seed=1]  |
+ *---------------------------------------------------------------*/
+#include "method/GPair.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/* ---------- прежний построитель: O(n^5) на std::find ---------- */
+std::vector<GPair>
+buildGPairsHVReference(const Graph& g, const std::vector<int>& omega,
+                       const std::vector<QPair>& Q)
+{
+    const int n = g.size();
+
+    std::vector<std::vector<int>> Hsets(n), Vsets(n);
+    for (int i = 0; i < n; ++i) {
+        bits::forEach(g.hRow(i), g.words(), [&](int j){ Hsets[i].push_back(j); });
+        bits::forEach(g.vRow(i), g.words(), [&](int j){ Vsets[i].push_back(j); });
+    }
+
+    std::vector<GPair> out;
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            if (!contains(omega, i) || !contains(omega, j)) continue;
+
+            std::vector<int> d_qr, d_rq;
+            for (int el : Hsets[i])
+                if (contains(Vsets[j], el) && contains(omega, el)) d_qr.push_back(el);
+
+            for (int el : Hsets[j])
+                if (contains(Vsets[i], el) && contains(omega, el)) d_rq.push_back(el);
+
+            std::vector<int> Dij;
+            for (int el : d_qr)
+                if (contains(d_rq, el)) Dij.push_back(el);
+
+            if (!contains(Dij, i) || !contains(Dij, j)) continue;
+
+            if (std::find(Q.begin(), Q.end(), QPair{i,j}) != Q.end()) continue;
+            out.push_back({i, j, std::move(Dij)});
+        }
+    }
+    std::sort(out.begin(), out.end(),
+        [](const GPair& a,const GPair& b){
+            if (a.set.size() != b.set.size()) return a.set.size() > b.set.size();
+            if (a.i != b.i) return a.i < b.i;
+            return a.j < b.j;
+        });
+    return out;
+}
+
+bool samePairs(const std::vector<GPair>& a, const std::vector<GPair>& b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t k = 0; k < a.size(); ++k)
+        if (a[k].i != b[k].i || a[k].j != b[k].j || a[k].set != b[k].set) return false;
+    return true;
+}
+
+DenseMatrix randomMatrix(int n, double density, std::mt19937_64& rng)
+{
+    std::bernoulli_distribution coin(density);
+    DenseMatrix A = DenseMatrix::Zero(n, n);
+    for (int i = 0; i < n; ++i)
+        for (int j = i + 1; j < n; ++j)
+            if (coin(rng)) A(i, j) = A(j, i) = 1;
+    return A;
+}
+
+template<class F>
+double seconds(F&& fn)
+{
+    auto t0 = Clock::now();
+    fn();
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int      n       = argc > 1 ? std::atoi(argv[1]) : 200;
+    double   density = argc > 2 ? std::atof(argv[2]) : 0.75;
+    int      graphs  = argc > 3 ? std::atoi(argv[3]) : 5;
+    uint64_t seed    = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+
+    std::mt19937_64 rng(seed);
+    std::bernoulli_distribution keep(0.7);          // ω глубже корня
+    double tRef = 0, tBits = 0;
+    int mismatches = 0;
+
+    for (int k = 0; k < graphs; ++k) {
+        Graph g(randomMatrix(n, density, rng));
+
+        std::vector<int> full(n), partial;
+        for (int v = 0; v < n; ++v) {
+            full[v] = v;
+            if (keep(rng)) partial.push_back(v);
+        }
+        const std::vector<QPair> Q;
+
+        for (const auto* omega : {&full, &partial}) {
+            std::vector<GPair> ref, fast;
+            tRef  += seconds([&]{ ref  = buildGPairsHVReference(g, *omega, Q); });
+            tBits += seconds([&]{ fast = buildGPairsHV(g, *omega, Q); });
+            if (!samePairs(ref, fast)) {
+                ++mismatches;
+                std::cerr << "Mismatch: graph " << k << ", |omega| = "
+                          << omega->size() << "\n";
+            }
+        }
+    }
+
+    std::cout << "n=" << n << " density=" << density
+              << " graphs=" << graphs << " seed=" << seed << '\n'
+              << "reference: " << tRef  << " s\n"
+              << "bitset:    " << tBits << " s\n"
+              << "speedup:   " << (tBits > 0 ? tRef / tBits : 0.0) << "x\n"
+              << "mismatches: " << mismatches << '\n';
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+/*---------------------------------------------------------------*
+ |  graph_convert: текстовые графы → двоичный контейнер .ogb      |
+ |  (GraphBinary.h), который потом открывается через mmap.        |
+ |                                                                 |
+ |  usage: graph_convert [--format matrix|dimacs|edges] [--dense]  |
+ |                       <input> <output.ogb>                      |
+ |         graph_convert --info <file.ogb>                         |
+ |                                                                 |
+ |  matrix — формат graphs.txt (n= / d= / matrix:), все графы      |
+ |  файла; dimacs — .col; edges — список рёбер. По умолчанию       |
+ |  .col/.clq читаются как DIMACS, остальное — как matrix.         |
+ |  --info проверяет каждый раздел целиком (смещения, соседи).     |
+ *---------------------------------------------------------------*/
+#include "GraphBinary.h"
+#include "GraphIO.h"
+#include "MatrixIO.h"
+
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+
+static int usage(const char* self)
+{
+    std::cerr << "usage: " << self << " [--format matrix|dimacs|edges] [--dense] <input> <output.ogb>\n"
+              << "       " << self << " --info <file.ogb>\n";
+    return 2;
+}
+
+static void info(const std::string& fileName)
+{
+    graphio::BinaryGraphFile f(fileName, /*verify=*/true);
+    std::cout << fileName << ": " << f.size() << " graph(s)\n";
+    for (std::size_t i = 0; i < f.size(); ++i) {
+        const auto s = f[i];
+        std::cout << "  #" << i + 1 << "  n=" << s.graph.size() << "  m=" << s.graph.edges();
+        if (s.density >= 0)   std::cout << "  d=" << s.density;
+        if (s.chromatic >= 0) std::cout << "  chi=" << s.chromatic;
+        if (s.dense)          std::cout << "  dense";
+        std::cout << '\n';
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string format, in, out;
+    bool dense = false, showInfo = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--dense")                      dense = true;
+        else if (a == "--info")                  showInfo = true;
+        else if (a == "--format" && i + 1 < argc) format = argv[++i];
+        else if (in.empty())                     in = a;
+        else if (out.empty())                    out = a;
+        else return usage(argv[0]);
+    }
+
+    try {
+        if (showInfo) {
+            if (in.empty() || !out.empty()) return usage(argv[0]);
+            info(in);
+            return 0;
+        }
+        if (in.empty() || out.empty()) return usage(argv[0]);
+
+        if (format.empty()) {
+            const auto dot = in.rfind('.');
+            const std::string ext = dot == std::string::npos ? "" : in.substr(dot);
+            format = (ext == ".col" || ext == ".clq") ? "dimacs" : "matrix";
+        }
+
+        std::size_t written = 0;
+        if (format == "matrix") {
+            const auto graphs = loadGraphs(in);
+            writeGraphsBinary(out, graphs, dense);
+            written = graphs.size();
+        } else if (format == "dimacs" || format == "edges") {
+            const CsrGraph g = format == "dimacs" ? graphio::readDimacs(in)
+                                                  : graphio::readEdgeList(in);
+            graphio::writeBinaryGraph(out, g, -1.0, -1, dense);
+            written = 1;
+        } else {
+            return usage(argv[0]);
+        }
+        std::cout << in << " -> " << out << ": " << written << " graph(s)\n";
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
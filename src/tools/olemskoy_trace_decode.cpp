@@ -0,0 +1,43 @@
+/*---------------------------------------------------------------*
+ |  olemskoy_trace_decode: двоичная трасса OlemskoyColorGraph     |
+ |  (writeTrace, сборка с OLEMSKOY_TRACE=FULL) → текст в формате  |
+ |  olemskoy_steps.txt.                                           |
+ |                                                                 |
+ |  usage: olemskoy_trace_decode <trace.bin> [olemskoy_steps.txt]  |
+ *---------------------------------------------------------------*/
+#include "method/OlemskoyTrace.h"
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <trace.bin> [out.txt]\n";
+        return 2;
+    }
+
+    std::ifstream fin(argv[1], std::ios::binary);
+    if (!fin) {
+        std::cerr << "Cannot open " << argv[1] << '\n';
+        return 1;
+    }
+
+    try {
+        if (argc > 2) {
+            std::ofstream fout(argv[2]);
+            if (!fout) {
+                std::cerr << "Cannot open " << argv[2] << '\n';
+                return 1;
+            }
+            otrace::decode(fin, fout);
+        } else {
+            otrace::decode(fin, std::cout);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[1] << ": " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}